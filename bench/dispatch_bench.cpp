@@ -0,0 +1,162 @@
+//----------------------------------------------------------------------
+// FILE: dispatch_bench.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Compares walking an AST through accept (two virtual calls per
+//       node) against switching on node kinds
+//----------------------------------------------------------------------
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "ast_parser.h"
+#include "lexer.h"
+
+using namespace std;
+
+
+// Counts the nodes of a program, reaching each statement, term, and
+// rvalue either through accept or by switching on its kind (the walk is
+// otherwise the same)
+template<bool SWITCH>
+class NodeCounter final : public Visitor
+{
+public:
+  long count = 0;
+  void visit(Program& p)
+  {
+    ++count;
+    for (StructDef& s : p.struct_defs)
+      visit(s);
+    for (FunDef& f : p.fun_defs)
+      visit(f);
+  }
+  void visit(FunDef& f) {++count; stmts(f.stmts);}
+  void visit(StructDef&) {++count;}
+  void visit(ReturnStmt& s) {++count; visit(s.expr);}
+  void visit(WhileStmt& s) {++count; visit(s.condition); stmts(s.stmts);}
+  void visit(ForStmt& s)
+  {
+    ++count;
+    visit(s.var_decl);
+    visit(s.condition);
+    visit(s.assign_stmt);
+    stmts(s.stmts);
+  }
+  void visit(IfStmt& s)
+  {
+    ++count;
+    visit(s.if_part.condition);
+    stmts(s.if_part.stmts);
+    for (BasicIf& b : s.else_ifs) {
+      visit(b.condition);
+      stmts(b.stmts);
+    }
+    stmts(s.else_stmts);
+  }
+  void visit(VarDeclStmt& s) {++count; visit(s.expr);}
+  void visit(AssignStmt& s) {++count; path(s.lvalue); visit(s.expr);}
+  void visit(DeleteStmt& s) {++count; visit(s.expr);}
+  void visit(CallExpr& e)
+  {
+    ++count;
+    for (Expr& a : e.args)
+      visit(a);
+  }
+  void visit(Expr& e)
+  {
+    ++count;
+    for (size_t i = 0; i <= e.rest.size(); ++i)
+      node(*e.term(i));
+  }
+  void visit(SimpleTerm& t) {++count; node(*t.rvalue);}
+  void visit(ComplexTerm& t) {++count; visit(t.expr);}
+  void visit(SimpleRValue&) {++count;}
+  void visit(NewRValue& v)
+  {
+    ++count;
+    if (v.array_expr)
+      visit(*v.array_expr);
+  }
+  void visit(VarRValue& v) {++count; path(v.path);}
+
+private:
+  template<typename T>
+  void node(T& n)
+  {
+    if constexpr (SWITCH)
+      dispatch(n, [this](auto& d) {visit(d);});
+    else
+      n.accept(*this);
+  }
+  void stmts(vector<Stmt*>& s)
+  {
+    for (Stmt* t : s)
+      node(*t);
+  }
+  void path(vector<VarRef>& p)
+  {
+    for (VarRef& r : p)
+      if (r.array_expr)
+        visit(*r.array_expr);
+  }
+};
+
+
+// a program of n functions, each with a mix of statements and
+// expressions
+string make_program(int n)
+{
+  string text = "int g(int x, int n) { return x - n }\nvoid main() {}\n";
+  for (int i = 0; i < n; ++i) {
+    text += "int f" + to_string(i) + "(int n, array int a) {\n";
+    text += "  int x = (n + 1) * 2 - a[0]\n";
+    text += "  while (x > 0 and not (x == 3)) {\n";
+    text += "    x = x - g(x, n)\n";
+    text += "    if (x < 10) { a[x] = x } elseif (x > 100) { return x }\n";
+    text += "    else { x = x / 2 }\n";
+    text += "  }\n";
+    text += "  for (int j = 0; j < n; j = j + 1) { a[j] = a[j] + j * x }\n";
+    text += "  return x\n";
+    text += "}\n";
+  }
+  return text;
+}
+
+
+template<bool SWITCH>
+double time_ns_per_node(Program& p, int rounds, long& nodes)
+{
+  auto begin = chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    NodeCounter<SWITCH> counter;
+    p.accept(counter);
+    nodes = counter.count;
+  }
+  auto end = chrono::steady_clock::now();
+  double ns = chrono::duration<double, nano>(end - begin).count();
+  return ns / (static_cast<double>(nodes) * rounds);
+}
+
+
+int main()
+{
+  Program p = ASTParser(Lexer(SourceBuffer::from_string(make_program(20000))))
+    .parse();
+  long virtual_nodes = 0;
+  long switch_nodes = 0;
+  const int rounds = 20;
+  double virt = time_ns_per_node<false>(p, rounds, virtual_nodes);
+  double swit = time_ns_per_node<true>(p, rounds, switch_nodes);
+  // sanity check that both walks reach the same nodes
+  if (virtual_nodes != switch_nodes) {
+    cerr << "node counts differ" << endl;
+    return 1;
+  }
+  cout << "nodes:          " << virtual_nodes << endl;
+  cout << "accept:         " << virt << " ns/node" << endl;
+  cout << "switch:         " << swit << " ns/node" << endl;
+  cout << "speedup:        " << virt / swit << "x" << endl;
+}
@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------
+// FILE: keyword_bench.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Compares keyword_type() against the original compare chain
+//----------------------------------------------------------------------
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "keywords.h"
+
+using namespace std;
+
+
+// the reserved word check the lexer used before keyword_type()
+TokenType compare_chain(const string& lexeme)
+{
+  if(lexeme.compare("struct") == 0) return TokenType::STRUCT;
+  else if(lexeme.compare("array") == 0) return TokenType::ARRAY;
+  else if(lexeme.compare("delete") == 0) return TokenType::DELETE;
+  else if(lexeme.compare("for") == 0) return TokenType::FOR;
+  else if(lexeme.compare("while") == 0) return TokenType::WHILE;
+  else if(lexeme.compare("if") == 0) return TokenType::IF;
+  else if(lexeme.compare("elseif") == 0) return TokenType::ELSEIF;
+  else if(lexeme.compare("else") == 0) return TokenType::ELSE;
+  else if(lexeme.compare("and") == 0) return TokenType::AND;
+  else if(lexeme.compare("or") == 0) return TokenType::OR;
+  else if(lexeme.compare("not") == 0) return TokenType::NOT;
+  else if(lexeme.compare("new") == 0) return TokenType::NEW;
+  else if(lexeme.compare("return") == 0) return TokenType::RETURN;
+  else if(lexeme.compare("and") == 0) return TokenType::AND;
+  else if(lexeme.compare("null") == 0) return TokenType::NULL_VAL;
+  else if(lexeme.compare("true") == 0) return TokenType::BOOL_VAL;
+  else if(lexeme.compare("false") == 0) return TokenType::BOOL_VAL;
+  else if(lexeme.compare("bool") == 0) return TokenType::BOOL_TYPE;
+  else if(lexeme.compare("int") == 0) return TokenType::INT_TYPE;
+  else if(lexeme.compare("double") == 0) return TokenType::DOUBLE_TYPE;
+  else if(lexeme.compare("char") == 0) return TokenType::CHAR_TYPE;
+  else if(lexeme.compare("string") == 0) return TokenType::STRING_TYPE;
+  else if(lexeme.compare("void") == 0) return TokenType::VOID_TYPE;
+  return TokenType::ID;
+}
+
+
+// a mix of roughly 70% identifiers and 30% reserved words
+vector<string> make_words(int count)
+{
+  vector<string> reserved = {"struct", "array", "delete", "for", "while",
+    "if", "elseif", "else", "and", "or", "not", "new", "return", "null",
+    "true", "false", "bool", "int", "double", "char", "string", "void"};
+  vector<string> ids = {"i", "x", "count", "total_sum", "node", "next",
+    "value", "left", "right", "result", "str", "index", "tmp", "n1", "n2"};
+  mt19937 gen(326);
+  uniform_int_distribution<int> pct(0, 99);
+  vector<string> words;
+  for (int i = 0; i < count; ++i) {
+    if (pct(gen) < 70)
+      words.push_back(ids[gen() % ids.size()]);
+    else
+      words.push_back(reserved[gen() % reserved.size()]);
+  }
+  return words;
+}
+
+
+template<typename F>
+double time_ns_per_word(const vector<string>& words, int rounds, F classify)
+{
+  volatile int sink = 0;
+  auto begin = chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r)
+    for (const string& w : words)
+      sink = sink + static_cast<int>(classify(w));
+  auto end = chrono::steady_clock::now();
+  double ns = chrono::duration<double, nano>(end - begin).count();
+  return ns / (static_cast<double>(words.size()) * rounds);
+}
+
+
+int main()
+{
+  vector<string> words = make_words(1 << 16);
+  // sanity check that both agree before timing them
+  for (const string& w : words)
+    if (compare_chain(w) != keyword_type(w)) {
+      cerr << "mismatch on '" << w << "'" << endl;
+      return 1;
+    }
+  const int rounds = 200;
+  double chain = time_ns_per_word(words, rounds, compare_chain);
+  double table = time_ns_per_word(words, rounds, [](const string& w) {
+    return keyword_type(w);
+  });
+  cout << "compare chain:  " << chain << " ns/word" << endl;
+  cout << "keyword_type:   " << table << " ns/word" << endl;
+  cout << "speedup:        " << chain / table << "x" << endl;
+}
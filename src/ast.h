@@ -7,15 +7,19 @@
 
 
 // NOTE: Guiding principle is to use heap as little as possible and
-// only use pointers when necessary
+// only use pointers when necessary. Pointed-to nodes are allocated in
+// (and owned by) their program's arena.
 
 
 #ifndef AST_H
 #define AST_H
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <optional>
+#include "ast_arena.h"
+#include "source_buffer.h"
 #include "token.h"
 
 
@@ -38,6 +42,23 @@ class SimpleRValue;
 class NewRValue;
 class VarRValue;
 
+
+// the kind of a statement, term, or rvalue node (so passes can switch
+// on it, see dispatch below, instead of double dispatching through
+// accept), also the node's kind byte in .ast files
+enum class NodeKind : std::uint8_t {
+  RETURN_STMT, WHILE_STMT, FOR_STMT, IF_STMT, VAR_DECL_STMT, ASSIGN_STMT,
+  DELETE_STMT, CALL_EXPR, SIMPLE_TERM, COMPLEX_TERM, SIMPLE_RVALUE,
+  NEW_RVALUE, VAR_RVALUE
+};
+
+
+// the index of a node in its program, from 0 (the program) up in the
+// order the parser makes the nodes (so ids are dense, and side tables
+// of per-node data can be vectors, see node_table.h)
+using NodeId = std::uint32_t;
+
+
 //----------------------------------------------------------------------
 // Visitor interface
 //----------------------------------------------------------------------
@@ -73,26 +94,41 @@ public:
 class ASTNode
 {
 public:
+  // nodes are built in place or moved, never copied (a copy would copy
+  // the node's whole subtree)
+  ASTNode() = default;
+  ASTNode(const ASTNode&) = delete;
+  ASTNode& operator=(const ASTNode&) = delete;
+  ASTNode(ASTNode&&) = default;
+  ASTNode& operator=(ASTNode&&) = default;
   virtual ~ASTNode() {};
   virtual void accept(Visitor& v) = 0;
+  NodeId id = 0;
 };
 
 class Stmt : public ASTNode
 {
+public:
+  Stmt(NodeKind k) : kind {k} {}
+  NodeKind kind;
 };
 
 class ExprTerm : public ASTNode
 {
 public:
+  ExprTerm(NodeKind k) : kind {k} {}
+  NodeKind kind;
   // helper to return first token in the term
-  virtual Token first_token() = 0;
+  virtual TokenRef first_token() = 0;
 };
 
 class RValue : public ASTNode
 {
 public:
+  RValue(NodeKind k) : kind {k} {}
+  NodeKind kind;
   // helper to return first token in the rvalue
-  virtual Token first_token() = 0;
+  virtual TokenRef first_token() = 0;
 };
 
 
@@ -106,6 +142,12 @@ class Program : public ASTNode
 public:
   std::vector<StructDef> struct_defs;
   std::vector<FunDef> fun_defs;
+  // source text referenced by the program's tokens
+  std::shared_ptr<const SourceBuffer> source;
+  // owner of the program's statement, term, and rvalue nodes
+  std::shared_ptr<AstArena> arena = std::make_shared<AstArena>();
+  // number of node ids used (all below it)
+  NodeId node_count = 0;
   void accept(Visitor& v) { v.visit(*this); }
 };
 
@@ -122,14 +164,14 @@ class VarDef
 {
 public:
   DataType data_type;
-  Token var_name;
-  Token first_token() {return var_name;}
+  TokenRef var_name;
+  TokenRef first_token() {return var_name;}
 };
 
 class StructDef : public ASTNode
 {
 public:
-  Token struct_name;
+  TokenRef struct_name;
   std::vector<VarDef> fields;
   void accept(Visitor& v) { v.visit(*this); }  
 };
@@ -139,9 +181,9 @@ class FunDef : public ASTNode
 {
 public:
   DataType return_type;
-  Token fun_name;
+  TokenRef fun_name;
   std::vector<VarDef> params;
-  std::vector<std::shared_ptr<Stmt>> stmts;
+  std::vector<Stmt*> stmts;
   void accept(Visitor& v) { v.visit(*this); }  
 };
 
@@ -151,58 +193,91 @@ public:
 //----------------------------------------------------------------------
 
 
+// A binary operator of an expression. Its operands are terms (~i for
+// the expression's term i) or earlier nodes (their index in nodes).
+class ExprNode
+{
+public:
+  std::uint32_t op;
+  std::int32_t lhs;
+  std::int32_t rhs;
+};
+
+// an operator of an expression and the term after it
+class ExprOp
+{
+public:
+  TokenRef op;
+  ExprTerm* term = nullptr;
+};
+
 class Expr : public ASTNode
 {
 public:
-  bool negated = false;
-  std::shared_ptr<ExprTerm> first = nullptr;
-  std::optional<Token> op = std::nullopt;
-  std::shared_ptr<Expr> rest = nullptr;
+  // the first term, then each operator and the term after it (in
+  // source order)
+  ExprTerm* first = nullptr;
+  std::vector<ExprOp> rest;
+  // indexes of the terms preceded by a 'not' (which negates the rest of
+  // the expression, starting at that term)
+  std::vector<std::uint32_t> negations;
+  // one node per operator (whose op is its index in rest), grouped by
+  // precedence, in postfix order (operands come before their operators,
+  // and the last node is the root)
+  std::vector<ExprNode> nodes;
   void accept(Visitor& v) { v.visit(*this); }  
-  Token first_token() {return first->first_token();}
+  TokenRef first_token() {return first->first_token();}
+  // the i-th term (0 for first, i for rest[i - 1])
+  ExprTerm* term(std::size_t i) {return i == 0 ? first : rest[i - 1].term;}
 };
 
 class SimpleTerm : public ExprTerm
 {
 public:
-  std::shared_ptr<RValue> rvalue = nullptr;
+  SimpleTerm() : ExprTerm {NodeKind::SIMPLE_TERM} {}
+  RValue* rvalue = nullptr;
   void accept(Visitor& v) { v.visit(*this); }
-  Token first_token() {return rvalue->first_token();}
+  TokenRef first_token() {return rvalue->first_token();}
 };
 
 
 class ComplexTerm : public ExprTerm
 {
 public:
+  ComplexTerm() : ExprTerm {NodeKind::COMPLEX_TERM} {}
   Expr expr;
   void accept(Visitor& v) { v.visit(*this); }      
-  Token first_token() {return expr.first_token();}
+  TokenRef first_token() {return expr.first_token();}
 };
 
 
 class SimpleRValue : public RValue
 {
 public:
-  Token value;
+  SimpleRValue() : RValue {NodeKind::SIMPLE_RVALUE} {}
+  TokenRef value;
+  // the value of an int or double literal (as converted when lexed)
+  TokenValue literal {NO_SYMBOL};
   void accept(Visitor& v) { v.visit(*this); }        
-  Token first_token() {return value;}
+  TokenRef first_token() {return value;}
 };
 
 
 class NewRValue : public RValue
 {
 public:
-  Token type;
+  NewRValue() : RValue {NodeKind::NEW_RVALUE} {}
+  TokenRef type;
   std::optional<Expr> array_expr;
   void accept(Visitor& v) { v.visit(*this); }        
-  Token first_token() {return type;}
+  TokenRef first_token() {return type;}
 };
 
 
 class VarRef
 {
 public:
-  Token var_name;
+  TokenRef var_name;
   std::optional<Expr> array_expr = std::nullopt; 
 };
 
@@ -210,9 +285,10 @@ public:
 class VarRValue : public RValue
 {
 public:
+  VarRValue() : RValue {NodeKind::VAR_RVALUE} {}
   std::vector<VarRef> path;
   void accept(Visitor& v) { v.visit(*this); }        
-  Token first_token() {return path[0].var_name;}
+  TokenRef first_token() {return path[0].var_name;}
 };
 
 
@@ -224,6 +300,7 @@ public:
 class ReturnStmt : public Stmt
 {
 public:
+  ReturnStmt() : Stmt {NodeKind::RETURN_STMT} {}
   Expr expr;
   void accept(Visitor& v) { v.visit(*this); }  
 };
@@ -231,6 +308,7 @@ public:
 class DeleteStmt : public Stmt
 {
 public:
+  DeleteStmt() : Stmt {NodeKind::DELETE_STMT} {}
   Expr expr;
   void accept(Visitor& v) { v.visit(*this); }  
 };
@@ -238,8 +316,9 @@ public:
 class WhileStmt : public Stmt
 {
 public:
+  WhileStmt() : Stmt {NodeKind::WHILE_STMT} {}
   Expr condition;
-  std::vector<std::shared_ptr<Stmt>> stmts;
+  std::vector<Stmt*> stmts;
   void accept(Visitor& v) { v.visit(*this); }  
 };
 
@@ -247,6 +326,7 @@ public:
 class VarDeclStmt : public Stmt
 {
 public:
+  VarDeclStmt() : Stmt {NodeKind::VAR_DECL_STMT} {}
   VarDef var_def;
   Expr expr;
   void accept(Visitor& v) { v.visit(*this); }  
@@ -256,6 +336,7 @@ public:
 class AssignStmt : public Stmt
 {
 public:
+  AssignStmt() : Stmt {NodeKind::ASSIGN_STMT} {}
   std::vector<VarRef> lvalue;
   Expr expr;
   void accept(Visitor& v) { v.visit(*this); }  
@@ -265,10 +346,11 @@ public:
 class ForStmt : public Stmt
 {
 public:
+  ForStmt() : Stmt {NodeKind::FOR_STMT} {}
   VarDeclStmt var_decl;
   Expr condition;
   AssignStmt assign_stmt;
-  std::vector<std::shared_ptr<Stmt>> stmts;
+  std::vector<Stmt*> stmts;
   void accept(Visitor& v) { v.visit(*this); }  
 };
 
@@ -277,16 +359,17 @@ class BasicIf
 {
 public:
   Expr condition;
-  std::vector<std::shared_ptr<Stmt>> stmts;
+  std::vector<Stmt*> stmts;
 };
 
 
 class IfStmt : public Stmt
 {
 public:
+  IfStmt() : Stmt {NodeKind::IF_STMT} {}
   BasicIf if_part;
   std::vector<BasicIf> else_ifs;
-  std::vector<std::shared_ptr<Stmt>> else_stmts;
+  std::vector<Stmt*> else_stmts;
   void accept(Visitor& v) { v.visit(*this); }  
 };
 
@@ -294,11 +377,70 @@ public:
 class CallExpr : public Stmt, public RValue
 {
 public:
-  Token fun_name;
+  CallExpr() : Stmt {NodeKind::CALL_EXPR}, RValue {NodeKind::CALL_EXPR} {}
+  // (the call's id is in both bases, as Stmt::id and RValue::id)
+  TokenRef fun_name;
   std::vector<Expr> args;
   void accept(Visitor& v) { v.visit(*this); }  
-  Token first_token() {return fun_name;}
+  TokenRef first_token() {return fun_name;}
 };
 
 
+
+//----------------------------------------------------------------------
+// Dispatch on node kinds
+//----------------------------------------------------------------------
+
+
+// Calls f on the statement as its own statement type (a switch on its
+// kind, which the compiler can inline, rather than two virtual calls)
+template<typename F>
+decltype(auto) dispatch(Stmt& s, F&& f)
+{
+  switch (s.kind) {
+  case NodeKind::RETURN_STMT:
+    return f(static_cast<ReturnStmt&>(s));
+  case NodeKind::WHILE_STMT:
+    return f(static_cast<WhileStmt&>(s));
+  case NodeKind::FOR_STMT:
+    return f(static_cast<ForStmt&>(s));
+  case NodeKind::IF_STMT:
+    return f(static_cast<IfStmt&>(s));
+  case NodeKind::VAR_DECL_STMT:
+    return f(static_cast<VarDeclStmt&>(s));
+  case NodeKind::ASSIGN_STMT:
+    return f(static_cast<AssignStmt&>(s));
+  case NodeKind::DELETE_STMT:
+    return f(static_cast<DeleteStmt&>(s));
+  default: // CALL_EXPR
+    return f(static_cast<CallExpr&>(s));
+  }
+}
+
+// same as above, for terms
+template<typename F>
+decltype(auto) dispatch(ExprTerm& t, F&& f)
+{
+  if (t.kind == NodeKind::SIMPLE_TERM)
+    return f(static_cast<SimpleTerm&>(t));
+  return f(static_cast<ComplexTerm&>(t));
+}
+
+// same as above, for rvalues
+template<typename F>
+decltype(auto) dispatch(RValue& r, F&& f)
+{
+  switch (r.kind) {
+  case NodeKind::SIMPLE_RVALUE:
+    return f(static_cast<SimpleRValue&>(r));
+  case NodeKind::NEW_RVALUE:
+    return f(static_cast<NewRValue&>(r));
+  case NodeKind::VAR_RVALUE:
+    return f(static_cast<VarRValue&>(r));
+  default: // CALL_EXPR
+    return f(static_cast<CallExpr&>(r));
+  }
+}
+
+
 #endif
@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------
+// FILE: ast_arena.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Bump allocator that owns the nodes of an AST
+//----------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstdint>
+#include "ast_arena.h"
+
+using namespace std;
+
+
+AstArena::~AstArena()
+{
+  for (auto d = destructors.rbegin(); d != destructors.rend(); ++d)
+    d->destroy(d->node);
+}
+
+
+void AstArena::adopt(AstArena& other)
+{
+  if (&other == this)
+    return;
+  // allocation continues in this arena's current block
+  for (auto& block : other.blocks)
+    blocks.push_back(move(block));
+  destructors.insert(destructors.end(), other.destructors.begin(),
+                     other.destructors.end());
+  used += other.used;
+  other.blocks.clear();
+  other.destructors.clear();
+  other.next = nullptr;
+  other.left = 0;
+  other.used = 0;
+}
+
+
+size_t AstArena::bytes_used() const
+{
+  return used;
+}
+
+
+void* AstArena::allocate(size_t size, size_t alignment)
+{
+  size_t padding = (alignment - reinterpret_cast<uintptr_t>(next) % alignment)
+    % alignment;
+  if (size + padding > left) {
+    // start a new block (blocks are aligned for any node)
+    size_t block_size = max(size, BLOCK_SIZE);
+    blocks.emplace_back(new byte[block_size]);
+    next = blocks.back().get();
+    left = block_size;
+    padding = 0;
+  }
+  void* space = next + padding;
+  next += padding + size;
+  left -= padding + size;
+  used += padding + size;
+  return space;
+}
@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------
+// FILE: ast_arena.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Bump allocator that owns the nodes of an AST
+//----------------------------------------------------------------------
+
+#ifndef AST_ARENA_H
+#define AST_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Allocates nodes one after another in large blocks, so that a tree's
+// nodes sit close together in memory, and frees them all at once (in
+// reverse order of creation) when the arena is destroyed.
+class AstArena
+{
+public:
+
+  AstArena() = default;
+  AstArena(const AstArena&) = delete;
+  AstArena& operator=(const AstArena&) = delete;
+  ~AstArena();
+
+  // construct a T in the arena from the given arguments (the node lives
+  // as long as the arena)
+  template<typename T, typename... Args>
+  T* make(Args&&... args);
+
+  // take over the nodes of other (e.g., of a separately parsed part of
+  // the same program), leaving it empty
+  void adopt(AstArena& other);
+
+  // number of bytes in use (including alignment padding)
+  std::size_t bytes_used() const;
+
+private:
+
+  // size of each block (larger nodes get a block of their own)
+  static constexpr std::size_t BLOCK_SIZE = std::size_t(64) << 10;
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks;
+  // free space in the current block
+  std::byte* next = nullptr;
+  std::size_t left = 0;
+  std::size_t used = 0;
+
+  // destructors still to run (those of trivially destructible nodes
+  // are skipped)
+  struct Destructor
+  {
+    void (*destroy)(void*);
+    void* node;
+  };
+  std::vector<Destructor> destructors;
+
+  // returns uninitialized, suitably aligned space of the given size
+  void* allocate(std::size_t size, std::size_t alignment);
+
+};
+
+
+template<typename T, typename... Args>
+T* AstArena::make(Args&&... args)
+{
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+  void* space = allocate(sizeof(T), alignof(T));
+  T* node = new (space) T(std::forward<Args>(args)...);
+  if constexpr (!std::is_trivially_destructible_v<T>)
+    destructors.push_back({[](void* p) { static_cast<T*>(p)->~T(); }, node});
+  return node;
+}
+
+
+#endif
@@ -0,0 +1,1027 @@
+//----------------------------------------------------------------------
+// FILE: ast_file.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Binary files of parsed programs (so unchanged scripts can skip
+//       lexing and parsing)
+//----------------------------------------------------------------------
+
+// An .ast file is a header followed by the program's source text, its
+// identifier names, and its nodes:
+//
+//   header | source | name lengths | names | nodes
+//
+// The nodes are written in the order a visitor reaches them, each
+// pointed-to node (statement, term, or rvalue) starting with a byte
+// giving its kind, and each list starting with its length. A token is
+// its type, the offset of its lexeme in the stored source (less the
+// previous token's offset, since tokens are mostly written in source
+// order), and then the index of its name for an ID or else the length
+// of its lexeme (the same parts as the AST's TokenRefs; the values of
+// int and double literals are converted from their lexemes once, on
+// loading). Numbers are written as variable-length integers (7 bits
+// per byte, low bits first, signed ones zigzag encoded), so most take
+// one byte.
+// Loading maps the file, reads the nodes in one pass into the new
+// program's arena (numbering them as the parser does, so node ids are
+// not stored), and uses the stored source (still in the mapped
+// file) as the program's source. As in .tok files, names are
+// re-interned once each, and the header and name lengths are in the
+// machine's byte order.
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include "ast_file.h"
+#include "lexer.h"
+
+using namespace std;
+
+
+// the fixed-size start of an .ast file
+struct AstFileHeader
+{
+  char magic[8];
+  uint32_t format;
+  uint32_t lexer_version;
+  uint64_t source_size;
+  // number of distinct identifier names and their total length
+  uint64_t name_count;
+  uint64_t names_size;
+  uint64_t nodes_size;
+};
+
+static_assert(sizeof(AstFileHeader) == 48);
+
+const char AST_FILE_MAGIC[8] = {'M', 'Y', 'P', 'L', 'A', 'S', 'T', '\0'};
+
+
+//----------------------------------------------------------------------
+// Writing
+//----------------------------------------------------------------------
+
+class AstWriter : public Visitor
+{
+public:
+
+  AstWriter(const SourceBuffer& source);
+
+  // the names of the program's identifiers (in order of first use) and
+  // its nodes
+  vector<string_view> names;
+  size_t names_size = 0;
+  vector<char> nodes;
+
+  void visit(Program& p);
+  void visit(FunDef& f);
+  void visit(StructDef& s);
+  void visit(ReturnStmt& s);
+  void visit(WhileStmt& s);
+  void visit(ForStmt& s);
+  void visit(IfStmt& s);
+  void visit(VarDeclStmt& s);
+  void visit(AssignStmt& s);
+  void visit(DeleteStmt& s);
+  void visit(CallExpr& e);
+  void visit(Expr& e);
+  void visit(SimpleTerm& t);
+  void visit(ComplexTerm& t);
+  void visit(SimpleRValue& v);
+  void visit(NewRValue& v);
+  void visit(VarRValue& v);
+
+private:
+
+  const SourceBuffer& source;
+  unordered_map<SymbolId, uint32_t> name_indexes;
+
+  // offset of the last token written
+  uint32_t last_offset = 0;
+
+  // expressions being written (innermost last), each with the index of
+  // its next term
+  struct ExprFrame
+  {
+    Expr* expr;
+    size_t next_term;
+  };
+  vector<ExprFrame> expr_frames;
+
+  void put_varint(uint64_t value);
+  void put_signed(int64_t value);
+  void put(NodeKind kind);
+  void put_count(size_t count);
+  void put(const string& s);
+  void put(TokenRef t);
+  void put(const DataType& t);
+  void put(const VarDef& v);
+  void put(vector<Stmt*>& stmts);
+  void put(vector<VarRef>& path);
+  void put(optional<Expr>& e);
+  void put_body(VarDeclStmt& s);
+  void put_body(AssignStmt& s);
+  void put_body(BasicIf& b);
+  void put_operators(Expr& e);
+};
+
+
+AstWriter::AstWriter(const SourceBuffer& a_source)
+  : source {a_source}
+{}
+
+
+void AstWriter::put_varint(uint64_t value)
+{
+  while (value >= 0x80) {
+    nodes.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  nodes.push_back(static_cast<char>(value));
+}
+
+
+void AstWriter::put_signed(int64_t value)
+{
+  put_varint((static_cast<uint64_t>(value) << 1) ^
+             static_cast<uint64_t>(value >> 63));
+}
+
+
+void AstWriter::put(NodeKind kind)
+{
+  nodes.push_back(static_cast<char>(kind));
+}
+
+
+void AstWriter::put_count(size_t count)
+{
+  put_varint(count);
+}
+
+
+void AstWriter::put(const string& s)
+{
+  put_count(s.size());
+  nodes.insert(nodes.end(), s.begin(), s.end());
+}
+
+
+void AstWriter::put(TokenRef t)
+{
+  // the lexeme must be part of the program's source
+  size_t length = t.lexeme_view(source).size();
+  if ((t.offset() > source.size()) || (length > source.size() - t.offset()))
+    throw MyPLException("token at offset " + to_string(t.offset()) +
+                        " is not in the program's source");
+  nodes.push_back(static_cast<char>(t.type()));
+  put_signed(static_cast<int64_t>(t.offset()) - last_offset);
+  last_offset = t.offset();
+  if (t.type() == TokenType::ID) {
+    auto [it, added] = name_indexes.try_emplace(t.symbol(), names.size());
+    if (added) {
+      names.push_back(Interner::global().name(t.symbol()));
+      names_size += names.back().size();
+    }
+    put_varint(it->second);
+  }
+  else
+    put_varint(length);
+}
+
+
+void AstWriter::put(const DataType& t)
+{
+  nodes.push_back(t.is_array);
+  put(t.type_name);
+}
+
+
+void AstWriter::put(const VarDef& v)
+{
+  put(v.data_type);
+  put(v.var_name);
+}
+
+
+void AstWriter::put(vector<Stmt*>& stmts)
+{
+  put_count(stmts.size());
+  for (Stmt* s : stmts)
+    s->accept(*this);
+}
+
+
+void AstWriter::put(vector<VarRef>& path)
+{
+  put_count(path.size());
+  for (VarRef& r : path) {
+    put(r.var_name);
+    put(r.array_expr);
+  }
+}
+
+
+void AstWriter::put(optional<Expr>& e)
+{
+  nodes.push_back(e.has_value());
+  if (e)
+    e->accept(*this);
+}
+
+
+void AstWriter::put_body(VarDeclStmt& s)
+{
+  put(s.var_def);
+  s.expr.accept(*this);
+}
+
+
+void AstWriter::put_body(AssignStmt& s)
+{
+  put(s.lvalue);
+  s.expr.accept(*this);
+}
+
+
+void AstWriter::put_body(BasicIf& b)
+{
+  b.condition.accept(*this);
+  put(b.stmts);
+}
+
+
+void AstWriter::visit(Program& p)
+{
+  put_count(p.struct_defs.size());
+  for (StructDef& s : p.struct_defs)
+    s.accept(*this);
+  put_count(p.fun_defs.size());
+  for (FunDef& f : p.fun_defs)
+    f.accept(*this);
+}
+
+
+void AstWriter::visit(FunDef& f)
+{
+  put(f.return_type);
+  put(f.fun_name);
+  put_count(f.params.size());
+  for (const VarDef& v : f.params)
+    put(v);
+  put(f.stmts);
+}
+
+
+void AstWriter::visit(StructDef& s)
+{
+  put(s.struct_name);
+  put_count(s.fields.size());
+  for (const VarDef& v : s.fields)
+    put(v);
+}
+
+
+void AstWriter::visit(ReturnStmt& s)
+{
+  put(NodeKind::RETURN_STMT);
+  s.expr.accept(*this);
+}
+
+
+void AstWriter::visit(WhileStmt& s)
+{
+  put(NodeKind::WHILE_STMT);
+  s.condition.accept(*this);
+  put(s.stmts);
+}
+
+
+void AstWriter::visit(ForStmt& s)
+{
+  put(NodeKind::FOR_STMT);
+  put_body(s.var_decl);
+  s.condition.accept(*this);
+  put_body(s.assign_stmt);
+  put(s.stmts);
+}
+
+
+void AstWriter::visit(IfStmt& s)
+{
+  put(NodeKind::IF_STMT);
+  put_body(s.if_part);
+  put_count(s.else_ifs.size());
+  for (BasicIf& b : s.else_ifs)
+    put_body(b);
+  put(s.else_stmts);
+}
+
+
+void AstWriter::visit(VarDeclStmt& s)
+{
+  put(NodeKind::VAR_DECL_STMT);
+  put_body(s);
+}
+
+
+void AstWriter::visit(AssignStmt& s)
+{
+  put(NodeKind::ASSIGN_STMT);
+  put_body(s);
+}
+
+
+void AstWriter::visit(DeleteStmt& s)
+{
+  put(NodeKind::DELETE_STMT);
+  s.expr.accept(*this);
+}
+
+
+void AstWriter::visit(CallExpr& e)
+{
+  put(NodeKind::CALL_EXPR);
+  put(e.fun_name);
+  put_count(e.args.size());
+  for (Expr& arg : e.args)
+    arg.accept(*this);
+}
+
+
+// Parenthesized terms are written through a stack of the expressions
+// still being written (as the reader reads them), so any depth of them
+// takes no extra recursion
+void AstWriter::visit(Expr& e)
+{
+  size_t frame_base = expr_frames.size();
+  expr_frames.push_back(ExprFrame {&e, 0});
+  while (expr_frames.size() > frame_base) {
+    ExprFrame& f = expr_frames.back();
+    Expr& curr = *f.expr;
+    if (f.next_term > curr.rest.size()) {
+      if (curr.rest.empty())
+        put_count(0);
+      put_operators(curr);
+      expr_frames.pop_back();
+      continue;
+    }
+    size_t i = f.next_term++;
+    // the operator count follows the first term
+    if (i == 1)
+      put_count(curr.rest.size());
+    if (i > 0)
+      put(curr.rest[i - 1].op);
+    ExprTerm* t = curr.term(i);
+    if (t->kind == NodeKind::COMPLEX_TERM) {
+      put(NodeKind::COMPLEX_TERM);
+      expr_frames.push_back(
+        ExprFrame {&static_cast<ComplexTerm*>(t)->expr, 0});
+    }
+    else
+      visit(static_cast<SimpleTerm&>(*t));
+  }
+}
+
+
+void AstWriter::put_operators(Expr& e)
+{
+  put_count(e.negations.size());
+  for (uint32_t i : e.negations)
+    put_varint(i);
+  put_count(e.nodes.size());
+  for (const ExprNode& n : e.nodes) {
+    put_varint(n.op);
+    put_signed(n.lhs);
+    put_signed(n.rhs);
+  }
+}
+
+
+void AstWriter::visit(SimpleTerm& t)
+{
+  put(NodeKind::SIMPLE_TERM);
+  t.rvalue->accept(*this);
+}
+
+
+void AstWriter::visit(ComplexTerm& t)
+{
+  put(NodeKind::COMPLEX_TERM);
+  t.expr.accept(*this);
+}
+
+
+void AstWriter::visit(SimpleRValue& v)
+{
+  put(NodeKind::SIMPLE_RVALUE);
+  put(v.value);
+}
+
+
+void AstWriter::visit(NewRValue& v)
+{
+  put(NodeKind::NEW_RVALUE);
+  put(v.type);
+  put(v.array_expr);
+}
+
+
+void AstWriter::visit(VarRValue& v)
+{
+  put(NodeKind::VAR_RVALUE);
+  put(v.path);
+}
+
+
+bool write_ast(Program& p, ostream& out)
+{
+  AstWriter writer(*p.source);
+  p.accept(writer);
+
+  AstFileHeader header;
+  memcpy(header.magic, AST_FILE_MAGIC, sizeof(header.magic));
+  header.format = AST_FILE_FORMAT;
+  header.lexer_version = LEXER_VERSION;
+  header.source_size = p.source->size();
+  header.name_count = writer.names.size();
+  header.names_size = writer.names_size;
+  header.nodes_size = writer.nodes.size();
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(p.source->begin(), p.source->size());
+  for (string_view name : writer.names) {
+    uint32_t length = name.size();
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+  }
+  for (string_view name : writer.names)
+    out.write(name.data(), name.size());
+  out.write(writer.nodes.data(), writer.nodes.size());
+  out.flush();
+  return !out.fail();
+}
+
+
+//----------------------------------------------------------------------
+// Loading
+//----------------------------------------------------------------------
+
+// Reads the nodes of a program. A malformed file (a bad kind, token,
+// or expression, a list longer than what is left of the file, or
+// nesting deeper than MAX_NESTING) makes the reader fail, after which
+// every read returns an empty value, and the partly read program is
+// discarded. Parenthesized terms are read through a stack of the
+// expressions still being read, so any depth of them takes no extra
+// recursion.
+// the deepest nesting of statement lists and of expressions inside
+// rvalues (call arguments, array sizes, and indexes) the reader takes,
+// each level of which is read recursively
+const size_t MAX_NESTING = 10000;
+
+class AstReader
+{
+public:
+
+  AstReader(const char* begin, const char* end,
+            shared_ptr<const SourceBuffer> source, vector<SymbolId> symbols,
+            AstArena& arena);
+
+  // read the program, returns false if the nodes are malformed
+  bool read(Program& p);
+
+private:
+
+  const char* next;
+  const char* end;
+  bool failed = false;
+  shared_ptr<const SourceBuffer> source;
+  vector<SymbolId> symbols;
+  AstArena& arena;
+
+  // offset of the last token read
+  uint32_t last_offset = 0;
+  // id of the next node read (nodes are read in the order the parser
+  // makes them, so they get the same ids)
+  NodeId next_id = 0;
+  // levels of recursive reads (see MAX_NESTING)
+  size_t nesting = 0;
+
+  // expressions being read (innermost last), each with the index of
+  // its next term and its number of operators (once read)
+  struct ExprFrame
+  {
+    Expr* expr;
+    size_t next_term;
+    size_t op_count;
+  };
+  vector<ExprFrame> expr_frames;
+
+  bool fail();
+  void number(ASTNode& n);
+  void number(CallExpr& c);
+  template<typename T> T* make();
+  uint8_t take_byte();
+  uint64_t take_varint();
+  int64_t take_signed();
+  size_t take_count();
+  void take(string& s);
+  void take(TokenRef& t);
+  void take(DataType& t);
+  void take(VarDef& v);
+  void take(vector<Stmt*>& stmts);
+  void take(vector<VarRef>& path);
+  void take(optional<Expr>& e);
+  void take(Expr& e);
+  void take_operators(Expr& e);
+  bool enter();
+  void take(CallExpr& c);
+  void take(VarDeclStmt& s);
+  void take(AssignStmt& s);
+  void take(BasicIf& b);
+  Stmt* take_stmt();
+  ExprTerm* take_term();
+  RValue* take_rvalue();
+};
+
+
+AstReader::AstReader(const char* begin, const char* a_end,
+                     shared_ptr<const SourceBuffer> a_source,
+                     vector<SymbolId> a_symbols, AstArena& a_arena)
+  : next {begin}, end {a_end}, source {move(a_source)},
+    symbols {move(a_symbols)}, arena {a_arena}
+{}
+
+
+bool AstReader::fail()
+{
+  failed = true;
+  next = end;
+  return false;
+}
+
+
+bool AstReader::enter()
+{
+  if (nesting == MAX_NESTING)
+    return fail();
+  ++nesting;
+  return true;
+}
+
+
+void AstReader::number(ASTNode& n)
+{
+  if (next_id == UINT32_MAX)
+    fail();
+  n.id = next_id++;
+}
+
+
+void AstReader::number(CallExpr& c)
+{
+  number(static_cast<Stmt&>(c));
+  c.RValue::id = c.Stmt::id;
+}
+
+
+template<typename T>
+T* AstReader::make()
+{
+  T* n = arena.make<T>();
+  number(*n);
+  return n;
+}
+
+
+uint8_t AstReader::take_byte()
+{
+  if (next == end) {
+    fail();
+    return 0;
+  }
+  return static_cast<uint8_t>(*next++);
+}
+
+
+uint64_t AstReader::take_varint()
+{
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte = take_byte();
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return value;
+  }
+  fail();
+  return 0;
+}
+
+
+int64_t AstReader::take_signed()
+{
+  uint64_t value = take_varint();
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+
+size_t AstReader::take_count()
+{
+  // every list element takes at least one byte
+  uint64_t count = take_varint();
+  if (count > static_cast<size_t>(end - next)) {
+    fail();
+    return 0;
+  }
+  return count;
+}
+
+
+void AstReader::take(string& s)
+{
+  size_t size = take_count();
+  s.assign(next, size);
+  next += size;
+}
+
+
+void AstReader::take(TokenRef& t)
+{
+  uint8_t type = take_byte();
+  int64_t offset = last_offset + take_signed();
+  if ((type > static_cast<uint8_t>(TokenType::DELETE)) || (offset < 0) ||
+      (static_cast<uint64_t>(offset) > source->size())) {
+    fail();
+    return;
+  }
+  last_offset = offset;
+  // an ID's name, otherwise the length of its lexeme
+  uint64_t extra = take_varint();
+  uint64_t length = extra;
+  if (type == static_cast<uint8_t>(TokenType::ID)) {
+    if (extra >= symbols.size()) {
+      fail();
+      return;
+    }
+    extra = symbols[extra];
+    length = Interner::global().name(extra).size();
+  }
+  if ((extra > TOKEN_REF_MAX) || (length > source->size() - offset)) {
+    fail();
+    return;
+  }
+  t = TokenRef(static_cast<TokenType>(type), offset, extra);
+}
+
+
+void AstReader::take(DataType& t)
+{
+  t.is_array = take_byte() != 0;
+  take(t.type_name);
+}
+
+
+void AstReader::take(VarDef& v)
+{
+  take(v.data_type);
+  take(v.var_name);
+}
+
+
+void AstReader::take(vector<Stmt*>& stmts)
+{
+  if (!enter())
+    return;
+  size_t count = take_count();
+  stmts.reserve(count);
+  for (size_t i = 0; i < count && !failed; ++i)
+    stmts.push_back(take_stmt());
+  --nesting;
+}
+
+
+void AstReader::take(vector<VarRef>& path)
+{
+  size_t count = take_count();
+  path.reserve(count);
+  for (size_t i = 0; i < count && !failed; ++i) {
+    VarRef& r = path.emplace_back();
+    take(r.var_name);
+    take(r.array_expr);
+  }
+}
+
+
+void AstReader::take(optional<Expr>& e)
+{
+  if (take_byte() != 0)
+    take(e.emplace());
+}
+
+
+void AstReader::take(Expr& e)
+{
+  if (!enter())
+    return;
+  size_t frame_base = expr_frames.size();
+  number(e);
+  expr_frames.push_back(ExprFrame {&e, 0, 0});
+  while ((expr_frames.size() > frame_base) && !failed) {
+    ExprFrame& f = expr_frames.back();
+    Expr& curr = *f.expr;
+    ExprTerm** slot = &curr.first;
+    if (f.next_term > 0) {
+      // the operator count follows the first term
+      if (f.next_term == 1) {
+        f.op_count = take_count();
+        curr.rest.reserve(f.op_count);
+      }
+      if (f.next_term > f.op_count) {
+        take_operators(curr);
+        expr_frames.pop_back();
+        continue;
+      }
+      ExprOp& op = curr.rest.emplace_back();
+      take(op.op);
+      slot = &op.term;
+    }
+    ++f.next_term;
+    // a parenthesized term's expression is read next, as a frame of
+    // its own (which may add to expr_frames)
+    *slot = take_term();
+  }
+  expr_frames.resize(frame_base);
+  --nesting;
+}
+
+
+void AstReader::take_operators(Expr& e)
+{
+  size_t terms = e.rest.size() + 1;
+  size_t count = take_count();
+  e.negations.reserve(count);
+  for (size_t i = 0; i < count && !failed; ++i) {
+    uint64_t term = take_varint();
+    if (term >= terms)
+      fail();
+    e.negations.push_back(term);
+  }
+  // one node per operator, whose operands are terms or earlier nodes
+  count = take_count();
+  if (count != e.rest.size())
+    fail();
+  e.nodes.reserve(count);
+  for (size_t i = 0; i < count && !failed; ++i) {
+    uint64_t op = take_varint();
+    int64_t lhs = take_signed();
+    int64_t rhs = take_signed();
+    for (int64_t operand : {lhs, rhs})
+      if ((operand < 0) ? (static_cast<uint64_t>(~operand) >= terms)
+                        : (static_cast<uint64_t>(operand) >= i))
+        fail();
+    if (op >= e.rest.size())
+      fail();
+    e.nodes.push_back(ExprNode {static_cast<uint32_t>(op),
+        static_cast<int32_t>(lhs), static_cast<int32_t>(rhs)});
+  }
+}
+
+
+void AstReader::take(CallExpr& c)
+{
+  take(c.fun_name);
+  size_t count = take_count();
+  c.args.reserve(count);
+  for (size_t i = 0; i < count && !failed; ++i)
+    take(c.args.emplace_back());
+}
+
+
+void AstReader::take(VarDeclStmt& s)
+{
+  take(s.var_def);
+  take(s.expr);
+}
+
+
+void AstReader::take(AssignStmt& s)
+{
+  take(s.lvalue);
+  take(s.expr);
+}
+
+
+void AstReader::take(BasicIf& b)
+{
+  take(b.condition);
+  take(b.stmts);
+}
+
+
+Stmt* AstReader::take_stmt()
+{
+  switch (static_cast<NodeKind>(take_byte())) {
+  case NodeKind::RETURN_STMT: {
+    ReturnStmt* s = make<ReturnStmt>();
+    take(s->expr);
+    return s;
+  }
+  case NodeKind::WHILE_STMT: {
+    WhileStmt* s = make<WhileStmt>();
+    take(s->condition);
+    take(s->stmts);
+    return s;
+  }
+  case NodeKind::FOR_STMT: {
+    ForStmt* s = make<ForStmt>();
+    number(s->var_decl);
+    take(s->var_decl);
+    take(s->condition);
+    number(s->assign_stmt);
+    take(s->assign_stmt);
+    take(s->stmts);
+    return s;
+  }
+  case NodeKind::IF_STMT: {
+    IfStmt* s = make<IfStmt>();
+    take(s->if_part);
+    size_t count = take_count();
+    s->else_ifs.reserve(count);
+    for (size_t i = 0; i < count && !failed; ++i)
+      take(s->else_ifs.emplace_back());
+    take(s->else_stmts);
+    return s;
+  }
+  case NodeKind::VAR_DECL_STMT: {
+    VarDeclStmt* s = make<VarDeclStmt>();
+    take(*s);
+    return s;
+  }
+  case NodeKind::ASSIGN_STMT: {
+    AssignStmt* s = make<AssignStmt>();
+    take(*s);
+    return s;
+  }
+  case NodeKind::DELETE_STMT: {
+    DeleteStmt* s = make<DeleteStmt>();
+    take(s->expr);
+    return s;
+  }
+  case NodeKind::CALL_EXPR: {
+    CallExpr* c = make<CallExpr>();
+    take(*c);
+    return c;
+  }
+  default:
+    fail();
+    return nullptr;
+  }
+}
+
+
+ExprTerm* AstReader::take_term()
+{
+  switch (static_cast<NodeKind>(take_byte())) {
+  case NodeKind::SIMPLE_TERM: {
+    SimpleTerm* t = make<SimpleTerm>();
+    t->rvalue = take_rvalue();
+    return t;
+  }
+  case NodeKind::COMPLEX_TERM: {
+    // its expression is read by the enclosing take(Expr&)
+    ComplexTerm* t = make<ComplexTerm>();
+    number(t->expr);
+    expr_frames.push_back(ExprFrame {&t->expr, 0, 0});
+    return t;
+  }
+  default:
+    fail();
+    return nullptr;
+  }
+}
+
+
+RValue* AstReader::take_rvalue()
+{
+  switch (static_cast<NodeKind>(take_byte())) {
+  case NodeKind::SIMPLE_RVALUE: {
+    SimpleRValue* v = make<SimpleRValue>();
+    take(v->value);
+    v->literal = literal_value(v->value.type(), v->value.lexeme_view(*source));
+    return v;
+  }
+  case NodeKind::NEW_RVALUE: {
+    NewRValue* v = make<NewRValue>();
+    take(v->type);
+    take(v->array_expr);
+    return v;
+  }
+  case NodeKind::VAR_RVALUE: {
+    VarRValue* v = make<VarRValue>();
+    take(v->path);
+    if (v->path.empty())
+      fail();
+    return v;
+  }
+  case NodeKind::CALL_EXPR: {
+    CallExpr* c = make<CallExpr>();
+    take(*c);
+    return c;
+  }
+  default:
+    fail();
+    return nullptr;
+  }
+}
+
+
+bool AstReader::read(Program& p)
+{
+  number(p);
+  size_t count = take_count();
+  p.struct_defs.reserve(count);
+  for (size_t i = 0; i < count && !failed; ++i) {
+    StructDef& s = p.struct_defs.emplace_back();
+    number(s);
+    take(s.struct_name);
+    size_t fields = take_count();
+    s.fields.reserve(fields);
+    for (size_t j = 0; j < fields && !failed; ++j)
+      take(s.fields.emplace_back());
+  }
+  count = take_count();
+  p.fun_defs.reserve(count);
+  for (size_t i = 0; i < count && !failed; ++i) {
+    FunDef& f = p.fun_defs.emplace_back();
+    number(f);
+    take(f.return_type);
+    take(f.fun_name);
+    size_t params = take_count();
+    f.params.reserve(params);
+    for (size_t j = 0; j < params && !failed; ++j)
+      take(f.params.emplace_back());
+    take(f.stmts);
+  }
+  p.node_count = next_id;
+  // the nodes must fill the rest of the file exactly
+  return !failed && (next == end);
+}
+
+
+optional<Program> load_ast(const string& path)
+{
+  // the file holds more than its source, so it may be larger
+  shared_ptr<SourceBuffer> file = SourceBuffer::from_file(path, SIZE_MAX);
+  if (!file)
+    return nullopt;
+  return load_ast(file);
+}
+
+
+optional<Program> load_ast(shared_ptr<const SourceBuffer> file)
+{
+  if (file->size() < sizeof(AstFileHeader))
+    return nullopt;
+  AstFileHeader header;
+  memcpy(&header, file->begin(), sizeof(header));
+  uint64_t left = file->size() - sizeof(header);
+  if ((memcmp(header.magic, AST_FILE_MAGIC, sizeof(header.magic)) != 0) ||
+      (header.format != AST_FILE_FORMAT) ||
+      (header.lexer_version != LEXER_VERSION) ||
+      (header.source_size > left) || (header.source_size > MAX_SOURCE_SIZE) ||
+      (header.name_count > left / 4) ||
+      (header.names_size > left) || (header.nodes_size > left) ||
+      (header.source_size + header.name_count * 4 + header.names_size +
+       header.nodes_size != left))
+    return nullopt;
+
+  // the source stays in the mapped file
+  const char* p = file->begin() + sizeof(header);
+  shared_ptr<const SourceBuffer> source =
+    SourceBuffer::slice(file, sizeof(header), header.source_size);
+  p += header.source_size;
+
+  // intern the names once each
+  const char* names = p + header.name_count * sizeof(uint32_t);
+  vector<SymbolId> symbols;
+  symbols.reserve(header.name_count);
+  size_t used = 0;
+  for (size_t i = 0; i < header.name_count; ++i) {
+    uint32_t length;
+    memcpy(&length, p + i * sizeof(uint32_t), sizeof(length));
+    if (length > header.names_size - used)
+      return nullopt;
+    symbols.push_back(Interner::global().intern(string_view(names + used,
+                                                            length)));
+    used += length;
+  }
+  if (used != header.names_size)
+    return nullopt;
+
+  const char* nodes = names + header.names_size;
+  Program program;
+  program.source = source;
+  AstReader reader(nodes, nodes + header.nodes_size, source, move(symbols),
+                   *program.arena);
+  if (!reader.read(program))
+    return nullopt;
+  return program;
+}
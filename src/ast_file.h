@@ -0,0 +1,43 @@
+//----------------------------------------------------------------------
+// FILE: ast_file.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Binary files of parsed programs (so unchanged scripts can skip
+//       lexing and parsing)
+//----------------------------------------------------------------------
+
+#ifndef AST_FILE_H
+#define AST_FILE_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include "ast.h"
+#include "source_buffer.h"
+
+
+// version of the .ast file layout (bumped whenever it, or the AST it
+// holds, changes)
+const std::uint32_t AST_FILE_FORMAT = 2;
+
+
+// Write the program, along with its source text, as a binary AST file.
+// Every token of the program must be in its source (throws a
+// MyPLException otherwise); returns false if the file could not be
+// written.
+bool write_ast(Program& p, std::ostream& out);
+
+
+// Returns the program stored in the given .ast file, with its nodes
+// read straight from the mapped file into the program's arena and its
+// source being the text stored in the file, or nullopt if the file
+// cannot be read or is not a valid .ast file of this format.
+std::optional<Program> load_ast(const std::string& path);
+
+// same as above, but for the bytes of an already loaded .ast file
+std::optional<Program> load_ast(std::shared_ptr<const SourceBuffer> file);
+
+
+#endif
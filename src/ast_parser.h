@@ -8,59 +8,220 @@
 #ifndef AST_PARSER_H
 #define AST_PARSER_H
 
-#include "mypl_exception.h"
-#include "lexer.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
 #include "ast.h"
+#include "parser.h"
+#include "token_cursor.h"
 
 
-class ASTParser
+// Builds the AST of the program as the grammar recognizes it, with
+// every node made in place (in its parent, or in the program's arena)
+class AstBuilder
 {
 public:
 
-  // crate a new recursive descent parer
-  ASTParser(const Lexer& lexer);
+  // node types built for each part of the grammar
+  using Program = ::Program;
+  using StructDef = ::StructDef;
+  using FunDef = ::FunDef;
+  using VarDef = ::VarDef;
+  using DataType = ::DataType;
+  using StmtList = std::vector<Stmt*>;
+  using VarDeclStmt = ::VarDeclStmt;
+  using AssignStmt = ::AssignStmt;
+  using IfStmt = ::IfStmt;
+  using BasicIf = ::BasicIf;
+  using WhileStmt = ::WhileStmt;
+  using ForStmt = ::ForStmt;
+  using ReturnStmt = ::ReturnStmt;
+  using DeleteStmt = ::DeleteStmt;
+  using CallExpr = ::CallExpr;
+  using Expr = ::Expr;
+  using RValueSlot = RValue*;
+  using NewRValue = ::NewRValue;
+  using SimpleRValue = ::SimpleRValue;
+  using Path = std::vector<VarRef>;
+
+  // the operand stack height when an expression starts, and where the
+  // operators of the expression it is nested in start
+  struct ExprMark
+  {
+    std::size_t operand_base;
+    std::size_t outer_operator_base;
+  };
+
+  // the (empty) program, whose arena the nodes are made in
+  Program program(const TokenCursor& t)
+  {
+    Program p;
+    p.source = t.source_buffer();
+    source = p.source.get();
+    arena = p.arena.get();
+    next_id = 0;
+    number(p);
+    return p;
+  }
+  // records how many ids the program's nodes used
+  void end_program(Program& p) {p.node_count = next_id;}
+
+  // definitions
+  StructDef& struct_def(Program& p)
+  {return number(p.struct_defs.emplace_back());}
+  FunDef& fun_def(Program& p) {return number(p.fun_defs.emplace_back());}
+  VarDef& field(StructDef& s) {return s.fields.emplace_back();}
+  VarDef& param(FunDef& f) {return f.params.emplace_back();}
+  DataType& return_type(FunDef& f) {return f.return_type;}
+  DataType& data_type(VarDef& v) {return v.data_type;}
+  void array_type(DataType& d) {d.is_array = true;}
+
+  // names and values taken from the current token
+  void name(StructDef& s, const TokenCursor& t) {s.struct_name = ref(t);}
+  void name(FunDef& f, const TokenCursor& t) {f.fun_name = ref(t);}
+  void name(VarDef& v, const TokenCursor& t) {v.var_name = ref(t);}
+  void name(CallExpr& c, const TokenCursor& t) {c.fun_name = ref(t);}
+  void type_name(DataType& d, const TokenCursor& t)
+  {d.type_name = t.token().lexeme();}
+  void value(SimpleRValue& r, const TokenCursor& t)
+  {
+    Token token = t.token();
+    r.value = TokenRef(token, *source);
+    r.literal = token.value();
+  }
+  void type(NewRValue& n, const TokenCursor& t) {n.type = ref(t);}
+  void path_name(Path& p, const TokenCursor& t)
+  {p.emplace_back().var_name = ref(t);}
+  Expr& index(Path& p) {return p.back().array_expr.emplace();}
+
+  // statements (each added to the end of the given list)
+  VarDeclStmt& var_decl_stmt(StmtList& s) {return add<VarDeclStmt>(s);}
+  AssignStmt& assign_stmt(StmtList& s) {return add<AssignStmt>(s);}
+  CallExpr& call_stmt(StmtList& s) {return add<CallExpr>(s);}
+  IfStmt& if_stmt(StmtList& s) {return add<IfStmt>(s);}
+  WhileStmt& while_stmt(StmtList& s) {return add<WhileStmt>(s);}
+  ForStmt& for_stmt(StmtList& s) {return add<ForStmt>(s);}
+  ReturnStmt& return_stmt(StmtList& s) {return add<ReturnStmt>(s);}
+  DeleteStmt& delete_stmt(StmtList& s) {return add<DeleteStmt>(s);}
+
+  // parts of statements
+  StmtList& stmts(FunDef& f) {return f.stmts;}
+  StmtList& stmts(BasicIf& b) {return b.stmts;}
+  StmtList& stmts(WhileStmt& w) {return w.stmts;}
+  StmtList& stmts(ForStmt& o) {return o.stmts;}
+  StmtList& else_stmts(IfStmt& i) {return i.else_stmts;}
+  BasicIf& if_part(IfStmt& i) {return i.if_part;}
+  BasicIf& else_if(IfStmt& i) {return i.else_ifs.emplace_back();}
+  Expr& condition(BasicIf& b) {return b.condition;}
+  Expr& condition(WhileStmt& w) {return w.condition;}
+  Expr& condition(ForStmt& o) {return o.condition;}
+  VarDeclStmt& for_var_decl(ForStmt& o) {return number(o.var_decl);}
+  AssignStmt& for_assign(ForStmt& o) {return number(o.assign_stmt);}
+  VarDef& var_def(VarDeclStmt& v) {return v.var_def;}
+  Path& lvalue(AssignStmt& a) {return a.lvalue;}
+  Expr& expr(VarDeclStmt& v) {return v.expr;}
+  Expr& expr(AssignStmt& a) {return a.expr;}
+  Expr& expr(ReturnStmt& r) {return r.expr;}
+  Expr& expr(DeleteStmt& d) {return d.expr;}
+  Expr& arg(CallExpr& c) {return c.args.emplace_back();}
+
+  // expressions (terms and operators are added in order, and grouped
+  // by precedence as they are; a parenthesized term is an expression
+  // of its own, open until closed)
+  ExprMark begin_expr(Expr& e);
+  void negation(Expr& e);
+  Expr& open_group(Expr& e);
+  Expr& close_group(Expr& inner);
+  RValueSlot& simple_term(Expr& e) {return add_term<SimpleTerm>(e).rvalue;}
+  void op(Expr& e, const TokenCursor& t);
+  void end_expr(Expr& e, ExprMark mark);
+
+  // rvalues (each stored in the given slot)
+  SimpleRValue& simple_rvalue(RValueSlot& r) {return set<SimpleRValue>(r);}
+  NewRValue& new_rvalue(RValueSlot& r) {return set<NewRValue>(r);}
+  CallExpr& call_rvalue(RValueSlot& r) {return set<CallExpr>(r);}
+  Path& var_rvalue(RValueSlot& r) {return set<VarRValue>(r).path;}
+  Expr& array_size(NewRValue& n) {return n.array_expr.emplace();}
 
-  // run the parser
-  Program parse();
-  
 private:
-  
-  Lexer lexer;
-  Token curr_token;
-  
-  // helper functions
-  void advance();
-  void eat(TokenType t, const std::string& msg);
-  bool match(TokenType t);
-  bool match(std::initializer_list<TokenType> types);
-  void error(const std::string& msg);
-  bool bin_op();
-
-  // recursive descent functions
-  void struct_def(Program& p);
-  void fun_def(Program& s);
-  void fields(StructDef& s);
-  void data_type(DataType& f);
-  void base_type();
-  void stmt(std::vector<std::shared_ptr<Stmt>>& s);
-  void vdecl_stmt(VarDeclStmt& v);
-  void assign_stmt(AssignStmt& a);
-  void delete_stmt(DeleteStmt& d);
-  void lvalue(std::vector<VarRef>& p);
-  void if_stmt(IfStmt& i);
-  void if_stmt_tail(IfStmt& i);
-  void while_stmt(WhileStmt& w);
-  void for_stmt(ForStmt& o);
-  void call_expr(CallExpr& c);
-  void ret_stmt(ReturnStmt& r);
-  void expr(Expr& e);
-  void rvalue(std::shared_ptr<RValue>& r);
-  void new_rvalue(NewRValue& n);
-  void base_rvalue(SimpleRValue& r);
-  void var_rvalue(std::vector<VarRef>& p);
-  void params(FunDef& f);
+
+  // arena of the program being parsed (where its nodes are allocated)
+  AstArena* arena = nullptr;
+  // source of the program being parsed (which its tokens refer to)
+  const SourceBuffer* source = nullptr;
+  // id of the next node made
+  NodeId next_id = 0;
+
+  // operands and operators of the expressions being parsed that are not
+  // yet grouped (shared by nested expressions, each above the last)
+  std::vector<std::int32_t> operand_stack;
+  std::vector<std::uint32_t> operator_stack;
+  // where the operators of the innermost expression start
+  std::size_t operator_base = 0;
+
+  // the enclosing expressions of the open parenthesized expressions
+  // (innermost last)
+  struct Group
+  {
+    Expr* outer;
+    ExprMark mark;
+  };
+  std::vector<Group> open_groups;
+
+  // makes a node of the top operator and its two operands
+  void reduce(Expr& e);
+
+  // the current token, as a reference into the program's source
+  TokenRef ref(const TokenCursor& t) const
+  {return TokenRef(t.token(), *source);}
+
+  // gives the node the next id (in both bases of a call)
+  template<typename T>
+  T& number(T& n)
+  {
+    NodeId id = new_id();
+    if constexpr (std::is_same_v<T, ::CallExpr>)
+      n.Stmt::id = n.RValue::id = id;
+    else
+      n.id = id;
+    return n;
+  }
+  NodeId new_id();
+
+  // makes a statement and adds it to the list
+  template<typename T>
+  T& add(StmtList& s)
+  {
+    T* n = &number(*arena->make<T>());
+    s.push_back(n);
+    return *n;
+  }
+
+  // makes an rvalue and stores it in the slot
+  template<typename T>
+  T& set(RValueSlot& r)
+  {
+    T* n = &number(*arena->make<T>());
+    r = n;
+    return *n;
+  }
+
+  // makes the next term of the expression (an operand of the grouping)
+  template<typename T>
+  T& add_term(Expr& e)
+  {
+    T* n = &number(*arena->make<T>());
+    (e.rest.empty() ? e.first : e.rest.back().term) = n;
+    operand_stack.push_back(~static_cast<std::int32_t>(e.rest.size()));
+    return *n;
+  }
 
 };
 
 
+// parses the program into its AST
+using ASTParser = Parser<AstBuilder>;
+
+
 #endif
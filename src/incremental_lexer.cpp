@@ -0,0 +1,117 @@
+//----------------------------------------------------------------------
+// FILE: incremental_lexer.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Relexing of edited sources (e.g., for an editor)
+//----------------------------------------------------------------------
+
+// The lexer carries no state from one token to the next, and no token
+// (or lookahead) continues past a newline (see parallel_lexer.cpp), so
+// lexing can restart at any line. Likewise, once the new lexer starts a
+// token after the edit at the same place (shifted) as an old token of
+// the same type, the rest of the text is unchanged, and so are the rest
+// of the tokens. The exception is an old lexer error, whose message has
+// the (now stale) line and column of the error. It is found again by
+// relexing the line of the last old token, where the error begins.
+
+#include <algorithm>
+#include "incremental_lexer.h"
+#include "lexer.h"
+
+using namespace std;
+
+
+// returns the offset of the start of the line containing offset
+static size_t line_begin(const SourceBuffer& source, size_t offset)
+{
+  const char* text = source.begin();
+  while ((offset > 0) && (text[offset - 1] != '\n'))
+    --offset;
+  return offset;
+}
+
+
+shared_ptr<SourceBuffer> apply_edit(const SourceBuffer& source,
+                                    const SourceEdit& edit)
+{
+  if ((edit.begin > edit.end) || (edit.end > source.size()))
+    throw MyPLException::LexerError("edit range out of bounds");
+  string text;
+  text.reserve(source.size() - (edit.end - edit.begin) + edit.text.size());
+  text.append(source.begin(), edit.begin);
+  text.append(edit.text);
+  text.append(source.begin() + edit.end, source.end());
+  return SourceBuffer::from_string(move(text));
+}
+
+
+TokenBuffer relex(const TokenBuffer& old_tokens, const SourceEdit& edit)
+{
+  shared_ptr<const SourceBuffer> old_source = old_tokens.source_buffer();
+  shared_ptr<const SourceBuffer> source = apply_edit(*old_source, edit);
+  ptrdiff_t shift = static_cast<ptrdiff_t>(edit.text.size()) -
+    static_cast<ptrdiff_t>(edit.end - edit.begin);
+  size_t edit_end = edit.begin + edit.text.size(); // in the new source
+  size_t count = old_tokens.size();
+
+  // an old error can only be reproduced from the last old token's line
+  size_t error_line = 0;
+  if (old_tokens.has_error() && (count > 0))
+    error_line = line_begin(*old_source,
+                            token_start(old_tokens.type(count - 1),
+                                        old_tokens.offset(count - 1)));
+
+  // keep the old tokens before the edited line (no token starts at a
+  // newline, so those are the tokens whose lexemes start before it)
+  size_t restart = line_begin(*old_source, edit.begin);
+  if (old_tokens.has_error())
+    restart = min(restart, error_line);
+  size_t keep = 0, high = count;
+  while (keep < high) {
+    size_t mid = keep + (high - keep) / 2;
+    if (old_tokens.offset(mid) < restart)
+      keep = mid + 1;
+    else
+      high = mid;
+  }
+  TokenBuffer tokens(source);
+  tokens.append(old_tokens, 0, keep, 0);
+
+  // relex until a token lines up with an old one
+  Lexer lexer(source, restart, source->size());
+  size_t next_old = keep; // first old token that might line up
+  bool synced = false;
+  try {
+    Token t;
+    do {
+      t = lexer.next_token();
+      size_t start = token_start(t.type(), t.offset());
+      if (!synced && (start >= edit_end)) {
+        size_t old_offset = t.offset() - shift;
+        while ((next_old < count) && (old_tokens.offset(next_old) < old_offset))
+          ++next_old;
+        if ((next_old < count) && (old_tokens.offset(next_old) == old_offset) &&
+            (old_tokens.type(next_old) == t.type())) {
+          if (!old_tokens.has_error()) {
+            tokens.append(old_tokens, next_old, count, shift);
+            return tokens;
+          }
+          // reuse the tokens up to the error's line, then relex it
+          if (error_line > start - shift) {
+            size_t last = next_old;
+            while (old_tokens.offset(last) < error_line)
+              ++last;
+            tokens.append(old_tokens, next_old, last, shift);
+            lexer = Lexer(source, error_line + shift, source->size());
+            synced = true;
+            continue;
+          }
+        }
+      }
+      tokens.push_back(t);
+    } while (t.type() != TokenType::EOS);
+  } catch (MyPLException& ex) {
+    tokens.set_error(ex);
+  }
+  return tokens;
+}
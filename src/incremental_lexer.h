@@ -0,0 +1,43 @@
+//----------------------------------------------------------------------
+// FILE: incremental_lexer.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Relexing of edited sources (e.g., for an editor)
+//----------------------------------------------------------------------
+
+#ifndef INCREMENTAL_LEXER_H
+#define INCREMENTAL_LEXER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "source_buffer.h"
+#include "token_buffer.h"
+
+
+// an edit that replaces the source bytes [begin, end) with text
+struct SourceEdit
+{
+  std::size_t begin;
+  std::size_t end;
+  std::string text;
+};
+
+
+// Returns a new source with the edit applied (throws a lexer error if
+// the edit's range is not within the source)
+std::shared_ptr<SourceBuffer> apply_edit(const SourceBuffer& source,
+                                         const SourceEdit& edit);
+
+
+// Returns the tokens of old_tokens' source with the edit applied. Only
+// the edited region is relexed: lexing restarts at the beginning of the
+// edited line, and once a token after the edit lines up with an old
+// token, the rest of the old tokens are reused with their offsets moved
+// (their lines and columns come from the new source). The result,
+// including any lexer error, is identical to lexing the edited source
+// from the beginning.
+TokenBuffer relex(const TokenBuffer& old_tokens, const SourceEdit& edit);
+
+
+#endif
@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------
+// FILE: interner.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Global string interner implementation
+//----------------------------------------------------------------------
+
+#include <mutex>
+#include "interner.h"
+
+using namespace std;
+
+
+Interner& Interner::global()
+{
+  static Interner interner;
+  return interner;
+}
+
+
+SymbolId Interner::intern(string_view name)
+{
+  {
+    shared_lock<shared_mutex> lock(mutex);
+    auto it = ids.find(name);
+    if (it != ids.end())
+      return it->second;
+  }
+  unique_lock<shared_mutex> lock(mutex);
+  auto it = ids.find(name); // another thread may have added it
+  if (it != ids.end())
+    return it->second;
+  SymbolId id = names.size();
+  names.emplace_back(name);
+  ids.emplace(names.back(), id);
+  return id;
+}
+
+
+SymbolId Interner::find(string_view name) const
+{
+  shared_lock<shared_mutex> lock(mutex);
+  auto it = ids.find(name);
+  if (it == ids.end())
+    return NO_SYMBOL;
+  return it->second;
+}
+
+
+string_view Interner::name(SymbolId id) const
+{
+  shared_lock<shared_mutex> lock(mutex);
+  return names[id];
+}
+
+
+size_t Interner::size() const
+{
+  shared_lock<shared_mutex> lock(mutex);
+  return names.size();
+}
@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------
+// FILE: interner.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Global string interner mapping identifiers to dense integer ids
+//----------------------------------------------------------------------
+
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+// dense id of an interned name (ids are assigned 0, 1, 2, ...)
+typedef std::uint32_t SymbolId;
+
+// the id of "no name" (e.g., for tokens that are not identifiers)
+const SymbolId NO_SYMBOL = std::numeric_limits<SymbolId>::max();
+
+
+class Interner
+{
+public:
+
+  // the process-wide interner shared by the lexer and later passes
+  static Interner& global();
+
+  // returns the id of name, assigning the next id if it is new
+  SymbolId intern(std::string_view name);
+
+  // returns the id of name if it has been interned, otherwise NO_SYMBOL
+  SymbolId find(std::string_view name) const;
+
+  // returns the name with the given id (valid for the interner's life)
+  std::string_view name(SymbolId id) const;
+
+  // returns the number of interned names
+  std::size_t size() const;
+
+private:
+
+  // guards ids and names (the lexer may intern from several threads)
+  mutable std::shared_mutex mutex;
+
+  // mapping from names (views into the names storage) to their ids
+  std::unordered_map<std::string_view, SymbolId> ids;
+
+  // storage for each name, indexed by id (a deque never moves them)
+  std::deque<std::string> names;
+
+};
+
+
+#endif
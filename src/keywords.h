@@ -0,0 +1,78 @@
+//----------------------------------------------------------------------
+// FILE: keywords.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Reserved word recognition for the MyPL lexer
+//----------------------------------------------------------------------
+
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <string_view>
+#include "token.h"
+
+
+// Returns the token type of the given word: the reserved word, type, or
+// value it names, or ID if it is not reserved. Dispatches on the
+// length and first character so that at most two comparisons are made.
+constexpr TokenType keyword_type(std::string_view word)
+{
+  switch (word.size()) {
+  case 2:
+    switch (word[0]) {
+    case 'i': if (word == "if") return TokenType::IF; break;
+    case 'o': if (word == "or") return TokenType::OR; break;
+    }
+    break;
+  case 3:
+    switch (word[0]) {
+    case 'a': if (word == "and") return TokenType::AND; break;
+    case 'f': if (word == "for") return TokenType::FOR; break;
+    case 'i': if (word == "int") return TokenType::INT_TYPE; break;
+    case 'n':
+      if (word == "new") return TokenType::NEW;
+      if (word == "not") return TokenType::NOT;
+      break;
+    }
+    break;
+  case 4:
+    switch (word[0]) {
+    case 'b': if (word == "bool") return TokenType::BOOL_TYPE; break;
+    case 'c': if (word == "char") return TokenType::CHAR_TYPE; break;
+    case 'e': if (word == "else") return TokenType::ELSE; break;
+    case 'n': if (word == "null") return TokenType::NULL_VAL; break;
+    case 't': if (word == "true") return TokenType::BOOL_VAL; break;
+    case 'v': if (word == "void") return TokenType::VOID_TYPE; break;
+    }
+    break;
+  case 5:
+    switch (word[0]) {
+    case 'a': if (word == "array") return TokenType::ARRAY; break;
+    case 'f': if (word == "false") return TokenType::BOOL_VAL; break;
+    case 'w': if (word == "while") return TokenType::WHILE; break;
+    }
+    break;
+  case 6:
+    switch (word[0]) {
+    case 'd':
+      if (word == "delete") return TokenType::DELETE;
+      if (word == "double") return TokenType::DOUBLE_TYPE;
+      break;
+    case 'e': if (word == "elseif") return TokenType::ELSEIF; break;
+    case 'r': if (word == "return") return TokenType::RETURN; break;
+    case 's':
+      if (word == "struct") return TokenType::STRUCT;
+      if (word == "string") return TokenType::STRING_TYPE;
+      break;
+    }
+    break;
+  }
+  return TokenType::ID;
+}
+
+static_assert(keyword_type("elseif") == TokenType::ELSEIF);
+static_assert(keyword_type("false") == TokenType::BOOL_VAL);
+static_assert(keyword_type("structs") == TokenType::ID);
+
+
+#endif
@@ -6,310 +6,339 @@
 //----------------------------------------------------------------------
 
 #include "lexer.h"
+#include "keywords.h"
+#include "scan.h"
+#include <charconv>
 #include <iostream>
 
 using namespace std;
 
 
+//----------------------------------------------------------------------
+// Character class tables
+//----------------------------------------------------------------------
+
+// the class of a character decides which scanner state it starts
+enum class CharClass : unsigned char {
+  OTHER, SPACE, NEWLINE, HASH, PUNCT, OPERATOR, BANG, QUOTE, DQUOTE, DIGIT,
+  ALPHA
+};
+
+struct CharTables
+{
+  // class of each byte
+  CharClass char_class[256] = {};
+  // token type of a one character token (PUNCT and OPERATOR)
+  TokenType single[256] = {};
+  // token type of an OPERATOR (or BANG) followed by '='
+  TokenType with_equal[256] = {};
+  // true if the byte is a decimal digit
+  bool digit[256] = {};
+};
+
+constexpr CharTables make_char_tables()
+{
+  CharTables t;
+  for (unsigned char c : {' ', '\t', '\r', '\v', '\f'})
+    t.char_class[c] = CharClass::SPACE;
+  t.char_class['\n'] = CharClass::NEWLINE;
+  t.char_class['#'] = CharClass::HASH;
+  t.char_class['\''] = CharClass::QUOTE;
+  t.char_class['"'] = CharClass::DQUOTE;
+  t.char_class['!'] = CharClass::BANG;
+  t.with_equal['!'] = TokenType::NOT_EQUAL;
+  const pair<char, TokenType> punct[] = {
+    {'.', TokenType::DOT}, {',', TokenType::COMMA},
+    {'(', TokenType::LPAREN}, {')', TokenType::RPAREN},
+    {'{', TokenType::LBRACE}, {'}', TokenType::RBRACE},
+    {';', TokenType::SEMICOLON}, {'[', TokenType::LBRACKET},
+    {']', TokenType::RBRACKET}, {'+', TokenType::PLUS},
+    {'-', TokenType::MINUS}, {'*', TokenType::TIMES},
+    {'/', TokenType::DIVIDE}};
+  for (auto [c, type] : punct) {
+    t.char_class[static_cast<unsigned char>(c)] = CharClass::PUNCT;
+    t.single[static_cast<unsigned char>(c)] = type;
+  }
+  const tuple<char, TokenType, TokenType> ops[] = {
+    {'=', TokenType::ASSIGN, TokenType::EQUAL},
+    {'<', TokenType::LESS, TokenType::LESS_EQ},
+    {'>', TokenType::GREATER, TokenType::GREATER_EQ}};
+  for (auto [c, type, type_eq] : ops) {
+    t.char_class[static_cast<unsigned char>(c)] = CharClass::OPERATOR;
+    t.single[static_cast<unsigned char>(c)] = type;
+    t.with_equal[static_cast<unsigned char>(c)] = type_eq;
+  }
+  for (int c = '0'; c <= '9'; ++c) {
+    t.char_class[c] = CharClass::DIGIT;
+    t.digit[c] = true;
+  }
+  for (int c = 'a'; c <= 'z'; ++c) {
+    t.char_class[c] = CharClass::ALPHA;
+    t.char_class[c - 'a' + 'A'] = CharClass::ALPHA;
+  }
+  return t;
+}
+
+constexpr CharTables TABLES = make_char_tables();
+
+static_assert(TABLES.char_class['_'] == CharClass::OTHER);
+
+
+// table lookups on raw (possibly signed) characters
+inline CharClass char_class(char c)
+{
+  return TABLES.char_class[static_cast<unsigned char>(c)];
+}
+
+inline bool is_digit(char c)
+{
+  return TABLES.digit[static_cast<unsigned char>(c)];
+}
+
+
+//----------------------------------------------------------------------
+// Lexer
+//----------------------------------------------------------------------
+
 Lexer::Lexer(istream& input_stream)
-  : input {input_stream}, column {0}, line {1}
+  : Lexer(SourceBuffer::from_stream(input_stream))
+{}
+
+
+Lexer::Lexer(shared_ptr<const SourceBuffer> source_buffer)
+  : source {source_buffer}, curr {source_buffer->begin()},
+    last {source_buffer->end()}
 {}
 
 
-char Lexer::read()
+Lexer::Lexer(shared_ptr<StreamSource> stream_source)
+  : stream {stream_source}
 {
-  ++column;
-  return input.get();
+  source = stream->next_window();
+  if (!source) // empty stream
+    source = SourceBuffer::from_string("");
+  curr = source->begin();
+  last = source->end();
 }
 
 
-char Lexer::peek()
+Lexer::Lexer(shared_ptr<const SourceBuffer> source_buffer, size_t begin,
+             size_t end)
+  : source {source_buffer}, curr {source_buffer->begin() + begin},
+    last {source_buffer->begin() + end}
+{}
+
+
+Lexer::Lexer(shared_ptr<const TokenBuffer> token_buffer)
+  : source {token_buffer->source_buffer()}, replay {token_buffer},
+    curr {source->end()}, last {source->end()}
+{}
+
+
+Token Lexer::make_token(TokenType type, const char* lexeme, size_t length,
+                        TokenValue value) const
 {
-  return input.peek();
+  return Token::from_source(type, source, lexeme - source->begin(), length,
+                            value);
 }
 
 
-void Lexer::error(const string& msg, int line, int column) const
+bool Lexer::next_window()
 {
-  throw MyPLException::LexerError(msg + " at line " + to_string(line) +
-                                  ", column " + to_string(column));
+  if (!stream)
+    return false;
+  shared_ptr<const SourceBuffer> window = stream->next_window();
+  if (!window) // keep the last window for the position of EOS
+    return false;
+  source = window;
+  curr = source->begin();
+  last = source->end();
+  return true;
 }
 
 
-Token Lexer::next_token()
+string Lexer::until_space(const char* pos) const
 {
-  char ch = read(); // takes in input
-  string lexeme = ""; // string to build up input if needed
-  if(ch == EOF) // if end of file returns end of file token
-      return Token(TokenType::EOS, "end-of-stream", line, column);
-  else if(ch == '\n') // if new line character updates line, resets column and returns next_token()
-  {
-    line++; 
-    column = 0;
-    return next_token();
-  }
-  else if(isspace(ch)) 
-    return next_token();
-  else if(ch == '#') // if there is a comment reads until it finds a new line character of EOF
-  {
-    while((ch != '\n') && (ch != EOF))
-      ch = read();
-    if(ch == '\n') // if new line character updates line, resets column and returns next_token()
-    {
-      line++;
-      column = 0;
-      if(peek() == EOF) // if the input after is EOF returns end of file token
-      {
-        ch = read();
-        return Token(TokenType::EOS, "end-of-stream", line, column);
-      }
-      return next_token();
-    }
-    else 
-    {
-      return Token(TokenType::EOS, "end-of-stream", line, column);
-    }
-  }
-  else if(ch == '=') // checks for = 
-  {
-    if(peek() == '=') // checks for ==
-    {
-      ch = read();
-      return Token(TokenType::EQUAL, "==", line, (column - 1));
-    }
-    else
-      return Token(TokenType::ASSIGN, "=", line, column);
-  }
-  // checks for punctuation
-  else if(ch == '.') 
-    return Token(TokenType::DOT, ".", line, column);
-  else if(ch == ',')
-    return Token(TokenType::COMMA, ",", line, column);
-  else if(ch == '(')
-    return Token(TokenType::LPAREN, "(", line, column);
-  else if(ch == ')')
-    return Token(TokenType::RPAREN, ")", line, column);
-  else if(ch == '{')
-    return Token(TokenType::LBRACE, "{", line, column);
-  else if(ch == '}')
-    return Token(TokenType::RBRACE, "}", line, column);
-  else if(ch == ';')
-    return Token(TokenType::SEMICOLON, ";", line, column);
-  else if(ch == '[')
-    return Token(TokenType::LBRACKET, "[", line, column);
-  else if(ch == ']')
-    return Token(TokenType::RBRACKET, "]", line, column);
-  // checks for operators
-  else if(ch == '+')
-    return Token(TokenType::PLUS, "+", line, column);
-  else if(ch == '-')
-    return Token(TokenType::MINUS, "-", line, column);
-  else if(ch == '*')
-    return Token(TokenType::TIMES, "*", line, column);
-  else if(ch == '/')
-    return Token(TokenType::DIVIDE, "/", line, column);
-  // checks for comparators
-  else if(ch == '<')
-  {
-    if(peek() == '=') // checks if it is <=
-    {
-      ch = read();
-      return Token(TokenType::LESS_EQ, "<=", line, (column -1));
-    }
-    else
-      return Token(TokenType::LESS, "<", line, column);
+  const char* end = pos;
+  while (end != last && char_class(*end) != CharClass::SPACE &&
+         char_class(*end) != CharClass::NEWLINE)
+    ++end;
+  return string(pos, end);
+}
+
+
+Token Lexer::next_replayed_token()
+{
+  if (replay_next < replay->size())
+    return replay->token(replay_next++);
+  if (replay->has_error())
+    replay->throw_error();
+  // keep returning EOS once the stream is done
+  if (replay->size() > 0)
+    return replay->token(replay->size() - 1);
+  return make_token(TokenType::EOS, last, 0);
+}
+
+
+TokenBuffer Lexer::tokenize_all()
+{
+  if (stream)
+    throw MyPLException::LexerError("cannot buffer the tokens of a stream");
+  TokenBuffer tokens(source);
+  tokens.reserve((last - curr) / 4 + 1); // roughly one token per 4 bytes
+  try {
+    Token t;
+    do {
+      t = next_token();
+      tokens.push_back(t);
+    } while (t.type() != TokenType::EOS);
+  } catch (MyPLException& ex) {
+    tokens.set_error(ex);
   }
-  else if(ch == '>')
-  {
-    if(peek() == '=') // checks if it is >=
-    {
-      ch = read();
-      return Token(TokenType::GREATER_EQ, ">=", line, (column - 1));
-    }
+  return tokens;
+}
+
+
+shared_ptr<const SourceBuffer> Lexer::source_buffer() const
+{
+  return source;
+}
+
+
+void Lexer::error(const string& msg, const char* pos) const
+{
+  SourcePosition at = source->position(pos - source->begin());
+  throw MyPLException::LexerError(msg + " at line " + to_string(at.line) +
+                                  ", column " + to_string(at.column));
+}
+
+
+Token Lexer::next_token()
+{
+  if (replay)
+    return next_replayed_token();
+
+  // skip whitespace, newlines, and comments (iteratively, so that long
+  // runs of blank or commented lines use no extra stack)
+  // (windows of a stream end at newlines, so no token spans two)
+  while ((curr != last) || next_window()) {
+    CharClass c = char_class(*curr);
+    if ((c == CharClass::SPACE) || (c == CharClass::NEWLINE))
+      curr = scan_blank(curr, last);
+    else if (c == CharClass::HASH) // comments run until the newline
+      curr = scan_newline(curr, last);
     else
-      return Token(TokenType::GREATER, ">", line, column);
+      break;
   }
-  else if(ch == '!')
-  {
-    if(peek() == '=') // checks if it is !=
-    {
-      ch = read();
-      return Token(TokenType::NOT_EQUAL, "!=", line, (column - 1));
+  if (curr == last) // if end of file returns end of file token
+    return make_token(TokenType::EOS, curr, 0);
+
+  const char* start = curr++;
+  unsigned char first = static_cast<unsigned char>(*start);
+  switch (char_class(*start)) {
+
+  // punctuation and single character operators
+  case CharClass::PUNCT:
+    return make_token(TABLES.single[first], start, 1);
+
+  // =, ==, <, <=, >, >=
+  case CharClass::OPERATOR:
+    if ((curr != last) && (*curr == '=')) {
+      ++curr;
+      return make_token(TABLES.with_equal[first], start, 2);
     }
-    else // finds the values for error to print
-    {
-      int start_equal = column;
-      string issue_equal = "";
-      while(!isspace(ch) && (ch != EOF))
-      {
-        issue_equal += ch;
-        ch = read();
-      }
-      error("expecting '!=' found '" + issue_equal + "'", line, start_equal);
+    return make_token(TABLES.single[first], start, 1);
+
+  // != (a lone ! is an error)
+  case CharClass::BANG:
+    if ((curr != last) && (*curr == '=')) {
+      ++curr;
+      return make_token(TABLES.with_equal[first], start, 2);
     }
-  }
-  // checks for chars
-  else if(ch == '\'')
-  {
-    int start_char = column;
-    if(peek() == '\'') // looks for empty character
-      error("empty character", line, (column + 1));
-    else
-    {
-      ch = read();
-      lexeme += ch;
-      if(ch == '\\') // searchs for backslash for special characters
-      {
-        if((peek() == 'n') || (peek() == 't') || (peek() == '0'))
-        {
-          ch = read(); 
-          lexeme += ch;
-          ch = read();
-          return Token(TokenType::CHAR_VAL, lexeme, line, start_char);
-        }
-        else
-          return Token(TokenType::CHAR_VAL, lexeme, line, start_char);
-      }
-      else if(ch == EOF)
-        error("found end-of-file in character", line, column);
-      else if(ch == '\n')
-        error("found end-of-line in character", line, column);
-      else if(peek() == '\'') // tokenizes the char
-      {
-        ch = read();
-        return Token(TokenType::CHAR_VAL, lexeme, line, start_char);
-      }
-      else // prints out error message for invalid char
-      {
-        ch = read();
-        string issue = "";
-        issue += ch;
-        error("expecting ' found " + issue, line, column);
+    error("expecting '!=' found '" + until_space(start) + "'", start);
+
+  // chars (including the \n, \t, and \0 escapes)
+  case CharClass::QUOTE: {
+    if ((curr != last) && (*curr == '\'')) // looks for empty character
+      error("empty character", curr);
+    if (curr == last)
+      error("found end-of-file in character", curr);
+    const char* value = curr++;
+    if (*value == '\\') { // searchs for backslash for special characters
+      if ((curr != last) && ((*curr == 'n') || (*curr == 't') ||
+                             (*curr == '0'))) {
+        ++curr;
+        if (curr != last) // skips the closing quote
+          ++curr;
+        return make_token(TokenType::CHAR_VAL, value, 2);
       }
+      return make_token(TokenType::CHAR_VAL, value, 1);
     }
-      
-  }
-  // checks for strings
-  else if(ch == '"')
-  {
-    int start_string = column;
-    ch = read();
-    while((ch != '"') && (ch != EOF) && (ch != '\n')) // builds up lexeme until end of string, EOF or new line
-    {
-      lexeme = lexeme + ch;
-      ch = read();
+    if (*value == '\n')
+      error("found end-of-line in character", value);
+    if ((curr != last) && (*curr == '\'')) { // tokenizes the char
+      ++curr;
+      return make_token(TokenType::CHAR_VAL, value, 1);
     }
-    if(ch == EOF) 
-      error("found end-of-file in string", line, column);
-    if(ch == '\n')
-      error("found end-of-line in string", line, column);
-    return Token(TokenType::STRING_VAL, lexeme, line, start_string);
+    // prints out error message for invalid char
+    string issue(1, (curr == last) ? static_cast<char>(EOF) : *curr);
+    error("expecting ' found " + issue, curr);
   }
-  // checks for ints and double vals
-  else if(isdigit(ch))
-  {
-    int start_num = column;
-    if((ch == '0') && (isdigit(peek()))) // checks for ints with a leading 0
-      error("leading zero in number", line, column);
-    lexeme = lexeme + ch;
-    while(isdigit(peek())) // adds digits to lexeme until .
-    {
-      ch = read();
-      lexeme = lexeme + ch;
-    }
-    if(peek() == '.')  
-    {
-      ch = read();
-      lexeme = lexeme + ch;
-      if(!isdigit(peek())) // prints an error if no digit after .
-        error("missing digit in '" + lexeme + "'", line, (column + 1));
-      while(isdigit(peek())) // adds digits to lexeme until it is not digit
-      {
-        ch = read();
-        lexeme = lexeme + ch;
-      }
-      return Token(TokenType::DOUBLE_VAL, lexeme, line, start_num);
-    }
-    else
-      return Token(TokenType::INT_VAL, lexeme, line, start_num);
-  }
-  // checks for reserve words, primitive types, bool vals and IDs
-  else if(isalpha(ch))
-  {
-    int start_word = column;
-    lexeme = lexeme + ch;
-    while(isdigit(peek()) || isalpha(peek()) || (peek() == '_')) // builds up lexeme until invalid input for lexeme
-    {
-      ch = read();
-      lexeme = lexeme + ch;
-    }
-    // checks lexeme against all disclosed types
-    if(lexeme.compare("struct") == 0)
-      return Token(TokenType::STRUCT, lexeme, line, start_word);
-    else if(lexeme.compare("array") == 0)
-      return Token(TokenType::ARRAY, lexeme, line, start_word);
-    else if(lexeme.compare("delete") == 0)
-      return Token(TokenType::DELETE, lexeme, line, start_word);
-    else if(lexeme.compare("for") == 0)
-      return Token(TokenType::FOR, lexeme, line, start_word);
-    else if(lexeme.compare("while") == 0)
-      return Token(TokenType::WHILE, lexeme, line, start_word);
-    else if(lexeme.compare("if") == 0)
-      return Token(TokenType::IF, lexeme, line, start_word);
-    else if(lexeme.compare("elseif") == 0)
-      return Token(TokenType::ELSEIF, lexeme, line, start_word);
-    else if(lexeme.compare("else") == 0)
-      return Token(TokenType::ELSE, lexeme, line, start_word);
-    else if(lexeme.compare("and") == 0)
-      return Token(TokenType::AND, lexeme, line, start_word);
-    else if(lexeme.compare("or") == 0)
-      return Token(TokenType::OR, lexeme, line, start_word);
-    else if(lexeme.compare("not") == 0)
-      return Token(TokenType::NOT, lexeme, line, start_word);
-    else if(lexeme.compare("new") == 0)
-      return Token(TokenType::NEW, lexeme, line, start_word);
-    else if(lexeme.compare("return") == 0)
-      return Token(TokenType::RETURN, lexeme, line, start_word);
-    else if(lexeme.compare("and") == 0)
-      return Token(TokenType::AND, lexeme, line, start_word);
-    else if(lexeme.compare("null") == 0)
-      return Token(TokenType::NULL_VAL, lexeme, line, start_word);
-    else if(lexeme.compare("true") == 0)
-      return Token(TokenType::BOOL_VAL, lexeme, line, start_word);
-    else if(lexeme.compare("false") == 0)
-      return Token(TokenType::BOOL_VAL, lexeme, line, start_word);
-    else if(lexeme.compare("bool") == 0)
-      return Token(TokenType::BOOL_TYPE, lexeme, line, start_word);
-    else if(lexeme.compare("int") == 0)
-      return Token(TokenType::INT_TYPE, lexeme, line, start_word);
-    else if(lexeme.compare("double") == 0)
-      return Token(TokenType::DOUBLE_TYPE, lexeme, line, start_word);
-    else if(lexeme.compare("char") == 0)
-      return Token(TokenType::CHAR_TYPE, lexeme, line, start_word);
-    else if(lexeme.compare("string") == 0)
-      return Token(TokenType::STRING_TYPE, lexeme, line, start_word);
-    else if(lexeme.compare("void") == 0)
-      return Token(TokenType::VOID_TYPE, lexeme, line, start_word);
-    else // if nothing is found it is marked as an ID
-      return Token(TokenType::ID, lexeme, line, start_word);
+
+  // strings (cannot span lines)
+  case CharClass::DQUOTE: {
+    curr = scan_string_body(curr, last);
+    if (curr == last)
+      error("found end-of-file in string", curr);
+    if (*curr == '\n')
+      error("found end-of-line in string", curr);
+    ++curr; // skips the closing quote
+    return make_token(TokenType::STRING_VAL, start + 1, curr - start - 2);
   }
-  else // returns and error for the input that was not picked up by the rest of the if statement
-  {
-    int start_else = column;
-    string issue_else = "";
-    while(!isspace(ch) && (ch != EOF))
-    {
-      issue_else += ch;
-      ch = read();
+
+  // ints and doubles
+  case CharClass::DIGIT: {
+    if ((*start == '0') && (curr != last) && is_digit(*curr))
+      error("leading zero in number", start);
+    curr = scan_digits(curr, last);
+    TokenValue value;
+    if ((curr == last) || (*curr != '.')) { // converted once, here
+      if (from_chars(start, curr, value.int_value).ec != errc())
+        error("int value out of range '" + string(start, curr) + "'", start);
+      return make_token(TokenType::INT_VAL, start, curr - start, value);
     }
-    error("unexpected character '" + issue_else + "'", line, start_else);
+    ++curr;
+    if ((curr == last) || !is_digit(*curr)) // no digit after the .
+      error("missing digit in '" + string(start, curr) + "'", curr);
+    curr = scan_digits(curr, last);
+    if (from_chars(start, curr, value.double_value).ec != errc())
+      error("double value out of range '" + string(start, curr) + "'", start);
+    return make_token(TokenType::DOUBLE_VAL, start, curr - start, value);
   }
-    
-    
 
+  // reserved words, primitive types, bool/null values, and IDs
+  case CharClass::ALPHA: {
+    curr = scan_word(curr, last);
+    string_view lexeme(start, curr - start);
+    TokenType type = keyword_type(lexeme);
+    if (type != TokenType::ID)
+      return make_token(type, start, lexeme.size());
+    return make_token(type, start, lexeme.size(), {symbol_of(lexeme)});
+  }
 
-      
+  // anything else cannot start a token
+  default:
+    error("unexpected character '" + until_space(start) + "'", start);
+  }
 }
 
-  
 
+SymbolId Lexer::symbol_of(string_view name)
+{
+  auto it = symbols.find(name);
+  if (it != symbols.end())
+    return it->second;
+  SymbolId id = Interner::global().intern(name);
+  symbols.emplace(Interner::global().name(id), id); // outlives the source
+  return id;
+}
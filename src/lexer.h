@@ -9,43 +9,104 @@
 #define LEXER_H
 
 #include <istream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include "interner.h"
 #include "mypl_exception.h"
+#include "source_buffer.h"
+#include "stream_source.h"
 #include "token.h"
+#include "token_buffer.h"
+
+
+// version of the lexer's output (token types, boundaries, values, and
+// error messages), bumped whenever any of it changes so that tokens
+// lexed by an older lexer (e.g., in a token cache) are not reused
+const std::uint32_t LEXER_VERSION = 1;
 
 
 class Lexer {
 public:
 
-  // Construct a new lexer from the given input stream
+  // Construct a new lexer from the given input stream (the stream is
+  // read in full into a source buffer)
   Lexer(std::istream& input_stream);
 
+  // Construct a new lexer over an already loaded source buffer
+  Lexer(std::shared_ptr<const SourceBuffer> source_buffer);
+
+  // Construct a new lexer that reads its source a window at a time (so
+  // its memory use does not grow with the input). Tokens keep their
+  // window alive for as long as they are in use.
+  Lexer(std::shared_ptr<StreamSource> stream_source);
+
+  // Construct a new lexer over only the bytes [begin, end) of the
+  // source buffer (used to lex chunks of a source)
+  Lexer(std::shared_ptr<const SourceBuffer> source_buffer, std::size_t begin,
+        std::size_t end);
+
+  // Construct a lexer that replays already lexed tokens (e.g., loaded
+  // from a token cache), ending with the buffer's error if it has one
+  Lexer(std::shared_ptr<const TokenBuffer> token_buffer);
+
   // Return the next available token in the input stream. Returns the
   // EOS (end of stream) token if no more tokens exist in the input
   // stream.
   Token next_token();
+
+  // Lex the rest of the input stream in one pass, returning every token
+  // up to and including EOS. A lexer error ends the buffer early and
+  // is recorded in it rather than thrown. (Not for streaming lexers,
+  // since a token buffer refers to a single source.)
+  TokenBuffer tokenize_all();
+
+  // Return the source text that the lexer's token lexemes refer to (for
+  // a streaming lexer, the current window)
+  std::shared_ptr<const SourceBuffer> source_buffer() const;
   
 private:
 
-  // input stream
-  std::istream& input;
+  // source text (shared so copies of the lexer keep it alive)
+  std::shared_ptr<const SourceBuffer> source;
 
-  // current line
-  int line;
-  
-  // current column
-  int column;
+  // stream the source windows come from (if streaming)
+  std::shared_ptr<StreamSource> stream;
+
+  // tokens being replayed (if replaying) and the next one to return
+  std::shared_ptr<const TokenBuffer> replay;
+  std::size_t replay_next = 0;
+
+  // next unread character and end of the source text
+  const char* curr;
+  const char* last;
+
+  // symbols of the names this lexer has seen (keyed by views into the
+  // interner), so repeated names skip the shared interner and its lock
+  std::unordered_map<std::string_view, SymbolId> symbols;
+
+  // returns the interned id of an identifier
+  SymbolId symbol_of(std::string_view name);
+
+  // returns a token for the given lexeme in the source (its line and
+  // column are found from its offset when needed, not tracked here)
+  Token make_token(TokenType type, const char* lexeme, std::size_t length,
+                   TokenValue value = {NO_SYMBOL}) const;
+
+  // returns the next replayed token
+  Token next_replayed_token();
 
-  // returns single character from input stream, advances stream, and
-  // increments column number
-  char read();
+  // moves on to the next window of a streaming lexer, returns false at
+  // the end of the stream (or if not streaming)
+  bool next_window();
 
-  // returns single character from input stream without advancing and
-  // without incrementing column number
-  char peek();
+  // returns the text from pos up to the next whitespace (for errors)
+  std::string until_space(const char* pos) const;
 
-  // create and throw a MyPLException object (exits lexer)
-  void error(const std::string& msg, int line, int column) const;
+  // create and throw a MyPLException object for an error at the given
+  // position (exits lexer)
+  [[noreturn]] void error(const std::string& msg, const char* pos) const;
   
 };
 
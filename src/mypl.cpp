@@ -5,11 +5,19 @@
 // DESC: Creates a basic skeleton for command line options used later
 //----------------------------------------------------------------------
 
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include "source_buffer.h"
+#include "stream_source.h"
 #include "lexer.h"
+#include "parallel_lexer.h"
+#include "parallel_parser.h"
+#include "token_writer.h"
+#include "token_cache.h"
 #include "simple_parser.h"
 #include "ast_parser.h"
+#include "ast_file.h"
 #include "print_visitor.h"
 #include "semantic_checker.h"
 
@@ -20,10 +28,12 @@ void print(istream* input);// prints the first word of the input
 void check(istream* input);// prints the first line of the input
 void ir(istream* input);// prints the first two lines of the input
 void df(istream* input);// prints the entire file(default)
+shared_ptr<const TokenBuffer> file_tokens(shared_ptr<const SourceBuffer> source);// tokens of a file (cached if MYPL_TOKEN_CACHE is set)
 
 
 
 int main(int argc, char* argv[])
+try
 { 
   istream* input = &cin; 
 
@@ -41,21 +51,18 @@ int main(int argc, char* argv[])
   {
 	if(argc == 3)// checks if it has a file
 	{
-		input = new ifstream(argv[2]);// sets the file to input
-		if(input -> fail())// checks if the file fails
+		shared_ptr<SourceBuffer> source = SourceBuffer::from_file(argv[2]);// maps the file into memory
+		if(!source)// checks if the file fails
 		{
 			cout << "ERROR:  Unable to open file '" << argv[2] << "'" << endl;
 		}
 		else
 		{
 			try {
-					Lexer lexer(*input);
-					Token t = lexer.next_token();
-					cout << to_string(t) << endl;
-					while (t.type() != TokenType::EOS) {
-						t = lexer.next_token();
-						cout << to_string(t) << endl;
-					}
+					TokenBuffer tokens = tokenize_parallel(source);
+					write_tokens(tokens, cout);
+					if (tokens.has_error())
+						tokens.throw_error();
 				} catch (MyPLException& ex) {
 					cerr << ex.what() << endl;
 				}
@@ -65,13 +72,8 @@ int main(int argc, char* argv[])
 	{
 		input = &cin;
 			try {
-					Lexer lexer(*input);
-					Token t = lexer.next_token();
-					cout << to_string(t) << endl;
-					while (t.type() != TokenType::EOS) {
-						t = lexer.next_token();
-						cout << to_string(t) << endl;
-					}
+					Lexer lexer(make_shared<StreamSource>(*input));// reads stdin a chunk at a time
+					write_tokens(lexer, cout);
 				} catch (MyPLException& ex) {
 					cerr << ex.what() << endl;
 				}
@@ -81,15 +83,14 @@ int main(int argc, char* argv[])
   {
 	if(argc == 3)// checks if it has a file
 	{
-		input = new ifstream(argv[2]);// sets the file to input
-		if(input -> fail())// checks if the file fails
+		shared_ptr<SourceBuffer> source = SourceBuffer::from_file(argv[2]);// maps the file into memory
+		if(!source)// checks if the file fails
 		{
 			cout << "ERROR:  Unable to open file '" << argv[2] << "'" << endl;
 		}
 		else
 			try {
-					Lexer lexer(*input);
-					SimpleParser parser(lexer);
+					SimpleParser parser(file_tokens(source));// parses from the lexed tokens
 					parser.parse();
 				} catch (MyPLException& ex) {
 					cerr << ex.what() << endl;
@@ -99,7 +100,7 @@ int main(int argc, char* argv[])
 	{
 		input = &cin;
 		try {
-				Lexer lexer(*input);
+				Lexer lexer(make_shared<StreamSource>(*input));
 				SimpleParser parser(lexer);
 				parser.parse();
 			} catch (MyPLException& ex) {
@@ -111,16 +112,14 @@ int main(int argc, char* argv[])
   {
 	if(argc == 3)// checks if it has a file
 	{
-		input = new ifstream(argv[2]);// sets the file to input
-		if(input -> fail())// checks if the file fails
+		shared_ptr<SourceBuffer> source = SourceBuffer::from_file(argv[2]);// maps the file into memory
+		if(!source)// checks if the file fails
 		{
 			cout << "ERROR:  Unable to open file '" << argv[2] << "'" << endl;
 		}
 		else
 			try {
-					Lexer lexer(*input);
-					ASTParser parser(lexer);
-					Program p = parser.parse();
+					Program p = parse_parallel(file_tokens(source));// parses the definitions on every core
 					PrintVisitor v(cout);
 					p.accept(v);
 				} catch (MyPLException& ex) {
@@ -131,9 +130,8 @@ int main(int argc, char* argv[])
 	{
 		input = &cin;
 		try {
-				Lexer lexer(*input);
-				ASTParser parser(lexer);
-				Program p = parser.parse();
+				shared_ptr<const SourceBuffer> source = SourceBuffer::from_stream(*input);// the ast refers into the whole program
+				Program p = parse_parallel(make_shared<TokenBuffer>(tokenize_parallel(source)));
 				PrintVisitor v(cout);
 				p.accept(v);
 			} catch (MyPLException& ex) {
@@ -145,16 +143,14 @@ int main(int argc, char* argv[])
   {
 	if(argc == 3)// checks if it has a file
 	{
-		input = new ifstream(argv[2]);// sets the file to input
-		if(input -> fail())// checks if the file fails
+		shared_ptr<SourceBuffer> source = SourceBuffer::from_file(argv[2]);// maps the file into memory
+		if(!source)// checks if the file fails
 		{
 			cout << "ERROR:  Unable to open file '" << argv[2] << "'" << endl;
 		}
 		else
 			try {
-					Lexer lexer(*input);
-					ASTParser parser(lexer);
-					Program p = parser.parse();
+					Program p = parse_parallel(file_tokens(source));// parses the definitions on every core
 					SemanticChecker v;
 					p.accept(v);
 				} catch (MyPLException& ex) {
@@ -165,9 +161,8 @@ int main(int argc, char* argv[])
 	{
 		input = &cin;
 		try {
-				Lexer lexer(*input);
-				ASTParser parser(lexer);
-				Program p = parser.parse();
+				shared_ptr<const SourceBuffer> source = SourceBuffer::from_stream(*input);// the ast refers into the whole program
+				Program p = parse_parallel(make_shared<TokenBuffer>(tokenize_parallel(source)));
 				SemanticChecker v;
 				p.accept(v);
 			} catch (MyPLException& ex) {
@@ -175,6 +170,45 @@ int main(int argc, char* argv[])
 			}
 	}
   }
+  else if(args[1] == "--emit-ast")
+  {
+	shared_ptr<const SourceBuffer> source;
+	if(argc == 3)// checks if it has a file
+		source = SourceBuffer::from_file(argv[2]);// maps the file into memory
+	else
+		source = SourceBuffer::from_stream(cin);// the whole program is written along with its ast
+	if(!source)// checks if the file fails
+	{
+		cout << "ERROR:  Unable to open file '" << argv[2] << "'" << endl;
+	}
+	else
+		try {
+				Program p = parse_parallel(argc == 3 ? file_tokens(source) : make_shared<TokenBuffer>(tokenize_parallel(source)));
+				if(!write_ast(p, cout))// writes the binary ast to stdout
+					cerr << "ERROR:  Unable to write AST" << endl;
+			} catch (MyPLException& ex) {
+				cerr << ex.what() << endl;
+			}
+  }
+  else if(args[1] == "--load-ast")
+  {
+	optional<Program> p;
+	if(argc == 3)// checks if it has a file
+		p = load_ast(argv[2]);// maps the file and reads its nodes
+	else
+		p = load_ast(SourceBuffer::from_stream(cin, SIZE_MAX));
+	if(!p)// checks if the file fails or is not an ast file
+	{
+		cout << "ERROR:  Unable to load AST file '" << (argc == 3 ? argv[2] : "stdin") << "'" << endl;
+	}
+	else
+		try {
+				SemanticChecker v;
+				p->accept(v);
+			} catch (MyPLException& ex) {
+				cerr << ex.what() << endl;
+			}
+  }
   else if(args[1] == "--ir")
   {
 	if(argc == 3)// checks if it has a file
@@ -214,6 +248,11 @@ int main(int argc, char* argv[])
   if(input != &cin)
   	delete input;
 }
+catch(MyPLException& ex)// e.g., a script file too large to lex
+{
+	cerr << ex.what() << endl;
+	return 1;
+}
 
 	void usage()
 	{
@@ -225,6 +264,19 @@ int main(int argc, char* argv[])
 		cout << " --print	pretty prints program" << endl;
 		cout << " --check	statically checks program" << endl;
 		cout << " --ir		print intermediate (code) representation" << endl;
+		cout << " --emit-ast	writes the parsed program as a binary AST file" << endl;
+		cout << " --load-ast	statically checks a program from a binary AST file" << endl;
+		cout << "Environment: " << endl;
+		cout << " MYPL_TOKEN_CACHE=dir	reuse the tokens of unchanged script files" << endl;
+	}
+
+	shared_ptr<const TokenBuffer> file_tokens(shared_ptr<const SourceBuffer> source)
+	{
+		const char* cache_dir = getenv("MYPL_TOKEN_CACHE");
+		if(!cache_dir || !*cache_dir)// lexes the whole file up front without a cache
+			return make_shared<TokenBuffer>(tokenize_parallel(source));
+		TokenCache cache(cache_dir);
+		return make_shared<TokenBuffer>(cache.tokenize(source));// skips lexing if the tokens are cached
 	}
 
 	void parse(istream* input)
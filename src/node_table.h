@@ -0,0 +1,53 @@
+//----------------------------------------------------------------------
+// FILE: node_table.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Side tables of per-node data, indexed by node id
+//----------------------------------------------------------------------
+
+#ifndef NODE_TABLE_H
+#define NODE_TABLE_H
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+#include "ast.h"
+
+
+// Holds one T for each node of a program, so a pass can attach what it
+// finds (e.g., inferred types, resolved definitions, or constant
+// values) to the nodes without adding members to the node classes.
+// Node ids are dense, so the table is a vector indexed by id. (A call
+// has its id in both of its bases, so it is looked up by either base
+// or by the id itself.)
+template<typename T>
+class NodeTable
+{
+public:
+
+  // entries are returned by reference, which vector<bool> cannot do
+  static_assert(!std::is_same_v<T, bool>, "use a NodeTable<char> instead");
+
+  NodeTable() = default;
+
+  // a table for the program's nodes, each holding the given value
+  explicit NodeTable(const Program& p, const T& value = T())
+    : values(p.node_count, value) {}
+
+  // the entry of the node (which must be in the table's program)
+  T& operator[](NodeId id) {return values[id];}
+  const T& operator[](NodeId id) const {return values[id];}
+  T& operator[](const ASTNode& n) {return values[n.id];}
+  const T& operator[](const ASTNode& n) const {return values[n.id];}
+
+  // number of entries (the program's node count)
+  std::size_t size() const {return values.size();}
+
+private:
+
+  std::vector<T> values;
+
+};
+
+
+#endif
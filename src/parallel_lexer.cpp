@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------
+// FILE: parallel_lexer.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Multi-threaded lexing of large sources
+//----------------------------------------------------------------------
+
+// Chunks always begin just after a newline. MyPL comments, strings,
+// and chars cannot contain a newline, so a chunk never starts inside
+// one of them. (The unchecked closing quote of an escaped char, e.g.,
+// '\n followed by a newline, can end a token with a newline, but the
+// token then ends exactly at the chunk boundary.) Tokens only record
+// source offsets, and lines and columns come from the source's line
+// index, so the chunks' tokens are simply concatenated in order.
+
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "lexer.h"
+#include "parallel_lexer.h"
+
+using namespace std;
+
+
+// a separately lexed piece of the source
+struct LexChunk
+{
+  size_t begin;
+  size_t end;
+  TokenBuffer tokens;
+};
+
+
+// lex the chunk [begin, end)
+static void lex_chunk(shared_ptr<const SourceBuffer> source, LexChunk& chunk)
+{
+  chunk.tokens = Lexer(source, chunk.begin, chunk.end).tokenize_all();
+}
+
+
+TokenBuffer tokenize_parallel(shared_ptr<const SourceBuffer> source,
+                              unsigned thread_count, size_t min_chunk)
+{
+  if (thread_count == 0)
+    thread_count = max(1u, thread::hardware_concurrency());
+  size_t size = source->size();
+  size_t chunk_count = min<size_t>(thread_count,
+                                   size / max<size_t>(min_chunk, 1));
+  if (chunk_count <= 1)
+    return Lexer(source).tokenize_all();
+
+  // split at the first newline after each even split point
+  const char* text = source->begin();
+  vector<LexChunk> chunks;
+  size_t begin = 0;
+  for (size_t i = 1; i <= chunk_count && begin < size; ++i) {
+    size_t end = size;
+    if (i < chunk_count) {
+      size_t target = max(begin, size / chunk_count * i);
+      const void* nl = memchr(text + target, '\n', size - target);
+      end = nl ? static_cast<const char*>(nl) - text + 1 : size;
+    }
+    chunks.push_back(LexChunk {begin, end, TokenBuffer(source)});
+    begin = end;
+  }
+
+  // lex every chunk concurrently
+  vector<thread> workers;
+  for (size_t i = 1; i < chunks.size(); ++i)
+    workers.emplace_back(lex_chunk, source, ref(chunks[i]));
+  lex_chunk(source, chunks[0]);
+  for (thread& t : workers)
+    t.join();
+
+  // stitch the chunks together in order, up to the first error
+  TokenBuffer tokens(source);
+  size_t total = 0;
+  for (const LexChunk& chunk : chunks)
+    total += chunk.tokens.size();
+  tokens.reserve(total);
+  for (size_t i = 0; i < chunks.size(); ++i) {
+    const LexChunk& chunk = chunks[i];
+    // every chunk but the last ends with an EOS that is dropped (a chunk
+    // that stopped at an error has no EOS)
+    size_t count = chunk.tokens.size();
+    if ((i + 1 < chunks.size()) && !chunk.tokens.has_error())
+      --count;
+    tokens.append(chunk.tokens, count);
+    if (chunk.tokens.has_error()) {
+      tokens.set_error(*chunk.tokens.lexer_error());
+      break;
+    }
+  }
+  return tokens;
+}
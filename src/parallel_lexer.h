@@ -0,0 +1,30 @@
+//----------------------------------------------------------------------
+// FILE: parallel_lexer.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Multi-threaded lexing of large sources
+//----------------------------------------------------------------------
+
+#ifndef PARALLEL_LEXER_H
+#define PARALLEL_LEXER_H
+
+#include <cstddef>
+#include <memory>
+#include "source_buffer.h"
+#include "token_buffer.h"
+
+
+// sources smaller than this many bytes per thread are lexed serially
+const std::size_t PARALLEL_MIN_CHUNK = std::size_t(4) << 20;
+
+
+// Lex the entire source into a token buffer, splitting it at newlines
+// into chunks that are lexed concurrently (by up to thread_count
+// threads, or one per core if 0). The result, including any lexer
+// error, is identical to Lexer(source).tokenize_all().
+TokenBuffer tokenize_parallel(std::shared_ptr<const SourceBuffer> source,
+                              unsigned thread_count = 0,
+                              std::size_t min_chunk = PARALLEL_MIN_CHUNK);
+
+
+#endif
@@ -0,0 +1,278 @@
+//----------------------------------------------------------------------
+// FILE: parallel_parser.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Multi-threaded parsing of programs with many definitions
+//----------------------------------------------------------------------
+
+// A program is a sequence of definitions, and parsing one definition
+// depends on nothing before it, so a run of whole definitions parses
+// on its own to the same nodes as it does within the program. The runs'
+// definitions are then moved into one program in order (each of its
+// lists stays in source order), which takes over the runs' arenas.
+// Runs are only split at definition starts, but if any run fails to
+// parse (e.g., a program with a syntax error whose starts were found
+// in the wrong places), the whole program is parsed again serially so
+// the error reported is exactly the serial parser's. Each run numbers
+// its nodes from 1 (after its own program), so a run's ids are then
+// shifted past those of the runs before it, giving every node the id
+// the serial parser would.
+
+#include <algorithm>
+#include <optional>
+#include <thread>
+#include "ast_parser.h"
+#include "parallel_parser.h"
+
+using namespace std;
+
+
+// a separately parsed run of definitions
+struct ParseChunk
+{
+  size_t begin;
+  size_t end;
+  optional<Program> program;
+};
+
+
+// parse the chunk's tokens [begin, end) (leaving its program empty on
+// an error)
+static void parse_chunk(shared_ptr<const TokenBuffer> tokens,
+                        ParseChunk& chunk)
+{
+  try {
+    chunk.program = ASTParser(tokens, chunk.begin, chunk.end).parse();
+  } catch (MyPLException&) {
+    chunk.program.reset();
+  }
+}
+
+
+// Adds an offset to the ids of the nodes of a run's definitions. The
+// terms of parenthesized expressions are reached through a stack
+// rather than recursion (as in the semantic checker).
+class IdShifter final : public Visitor
+{
+public:
+  IdShifter(NodeId a_offset) : offset {a_offset} {}
+  void visit(Program& p)
+  {
+    for (StructDef& s : p.struct_defs)
+      visit(s);
+    for (FunDef& f : p.fun_defs)
+      visit(f);
+  }
+  void visit(FunDef& f) {shift(f); visit(f.stmts);}
+  void visit(StructDef& s) {shift(s);}
+  void visit(ReturnStmt& s) {shift(s); visit(s.expr);}
+  void visit(WhileStmt& s) {shift(s); visit(s.condition); visit(s.stmts);}
+  void visit(ForStmt& s)
+  {
+    shift(s);
+    visit(s.var_decl);
+    visit(s.condition);
+    visit(s.assign_stmt);
+    visit(s.stmts);
+  }
+  void visit(IfStmt& s)
+  {
+    shift(s);
+    visit(s.if_part);
+    for (BasicIf& b : s.else_ifs)
+      visit(b);
+    visit(s.else_stmts);
+  }
+  void visit(VarDeclStmt& s) {shift(s); visit(s.expr);}
+  void visit(AssignStmt& s) {shift(s); visit(s.lvalue); visit(s.expr);}
+  void visit(DeleteStmt& s) {shift(s); visit(s.expr);}
+  void visit(CallExpr& e)
+  {
+    e.Stmt::id += offset;
+    e.RValue::id += offset;
+    for (Expr& a : e.args)
+      visit(a);
+  }
+  void visit(Expr& e)
+  {
+    size_t base = groups.size();
+    groups.push_back(&e);
+    while (groups.size() > base) {
+      Expr& g = *groups.back();
+      groups.pop_back();
+      shift(g);
+      for (size_t i = 0; i <= g.rest.size(); ++i) {
+        ExprTerm* t = g.term(i);
+        shift(*t);
+        if (t->kind == NodeKind::COMPLEX_TERM)
+          groups.push_back(&static_cast<ComplexTerm*>(t)->expr);
+        else
+          visit(*static_cast<SimpleTerm*>(t)->rvalue);
+      }
+    }
+  }
+  void visit(SimpleTerm& t) {shift(t); visit(*t.rvalue);}
+  void visit(ComplexTerm& t) {shift(t); visit(t.expr);}
+  void visit(SimpleRValue& v) {shift(v);}
+  void visit(NewRValue& v)
+  {
+    shift(v);
+    if (v.array_expr)
+      visit(*v.array_expr);
+  }
+  void visit(VarRValue& v) {shift(v); visit(v.path);}
+
+private:
+  NodeId offset;
+  // parenthesized expressions still to shift
+  vector<Expr*> groups;
+
+  void shift(ASTNode& n) {n.id += offset;}
+  void visit(Stmt& s) {dispatch(s, [this](auto& n) {visit(n);});}
+  void visit(RValue& v) {dispatch(v, [this](auto& n) {visit(n);});}
+  void visit(vector<Stmt*>& stmts)
+  {
+    for (Stmt* s : stmts)
+      visit(*s);
+  }
+  void visit(BasicIf& b) {visit(b.condition); visit(b.stmts);}
+  void visit(vector<VarRef>& path)
+  {
+    for (VarRef& r : path)
+      if (r.array_expr)
+        visit(*r.array_expr);
+  }
+};
+
+
+// shift the ids of the chunk's nodes by offset
+static void shift_chunk(ParseChunk& chunk, NodeId offset)
+{
+  IdShifter shifter(offset);
+  chunk.program->accept(shifter);
+}
+
+
+// true if the token can be the last token of a function's return type
+static bool ends_return_type(TokenType type)
+{
+  switch (type) {
+  case TokenType::ID:
+  case TokenType::INT_TYPE:
+  case TokenType::DOUBLE_TYPE:
+  case TokenType::BOOL_TYPE:
+  case TokenType::STRING_TYPE:
+  case TokenType::CHAR_TYPE:
+  case TokenType::VOID_TYPE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+
+vector<size_t> definition_starts(const TokenBuffer& tokens)
+{
+  vector<size_t> starts;
+  size_t count = tokens.size();
+  int depth = 0;
+  for (size_t i = 0; i < count; ++i) {
+    TokenType type = tokens.type(i);
+    if (type == TokenType::LBRACE)
+      ++depth;
+    else if (type == TokenType::RBRACE)
+      --depth;
+    else if (depth != 0)
+      continue;
+    else if (type == TokenType::STRUCT)
+      starts.push_back(i);
+    else if ((type == TokenType::LPAREN) && (i >= 2) &&
+             (tokens.type(i - 1) == TokenType::ID) &&
+             ends_return_type(tokens.type(i - 2))) {
+      size_t start = i - 2;
+      if ((start > 0) && (tokens.type(start - 1) == TokenType::ARRAY))
+        --start;
+      starts.push_back(start);
+    }
+  }
+  return starts;
+}
+
+
+Program parse_parallel(shared_ptr<const TokenBuffer> tokens,
+                       unsigned thread_count, size_t min_chunk)
+{
+  if (thread_count == 0)
+    thread_count = max(1u, thread::hardware_concurrency());
+  size_t count = tokens->size();
+  size_t chunk_count = min<size_t>(thread_count,
+                                   count / max<size_t>(min_chunk, 1));
+  // a lexer error is reported by the serial parser (if it gets that far)
+  if ((chunk_count <= 1) || tokens->has_error())
+    return ASTParser(tokens).parse();
+
+  // split at the first definition start after each even split point
+  vector<size_t> starts = definition_starts(*tokens);
+  vector<ParseChunk> chunks;
+  size_t begin = 0;
+  for (size_t i = 1; i <= chunk_count && begin < count; ++i) {
+    size_t end = count;
+    if (i < chunk_count) {
+      size_t target = max(begin + 1, count / chunk_count * i);
+      auto start = lower_bound(starts.begin(), starts.end(), target);
+      end = (start != starts.end()) ? *start : count;
+    }
+    chunks.push_back(ParseChunk {begin, end, nullopt});
+    begin = end;
+  }
+  if (chunks.size() == 1)
+    return ASTParser(tokens).parse();
+
+  // parse every chunk concurrently
+  vector<thread> workers;
+  for (size_t i = 1; i < chunks.size(); ++i)
+    workers.emplace_back(parse_chunk, tokens, ref(chunks[i]));
+  parse_chunk(tokens, chunks[0]);
+  for (thread& t : workers)
+    t.join();
+  for (const ParseChunk& chunk : chunks)
+    if (!chunk.program)
+      return ASTParser(tokens).parse();
+
+  // number each chunk's nodes after those of the chunks before it (a
+  // program with too many nodes is left to the serial parser's error)
+  vector<NodeId> offsets;
+  uint64_t node_count = 1;
+  for (const ParseChunk& chunk : chunks) {
+    offsets.push_back(node_count - 1);
+    node_count += chunk.program->node_count - 1;
+  }
+  if (node_count > UINT32_MAX)
+    return ASTParser(tokens).parse();
+  workers.clear();
+  for (size_t i = 1; i < chunks.size(); ++i)
+    workers.emplace_back(shift_chunk, ref(chunks[i]), offsets[i]);
+  for (thread& t : workers)
+    t.join();
+
+  // move the chunks' definitions into one program in order
+  Program p;
+  p.source = tokens->source_buffer();
+  p.node_count = node_count;
+  size_t struct_count = 0, fun_count = 0;
+  for (const ParseChunk& chunk : chunks) {
+    struct_count += chunk.program->struct_defs.size();
+    fun_count += chunk.program->fun_defs.size();
+  }
+  p.struct_defs.reserve(struct_count);
+  p.fun_defs.reserve(fun_count);
+  for (ParseChunk& chunk : chunks) {
+    Program& part = *chunk.program;
+    move(part.struct_defs.begin(), part.struct_defs.end(),
+         back_inserter(p.struct_defs));
+    move(part.fun_defs.begin(), part.fun_defs.end(),
+         back_inserter(p.fun_defs));
+    p.arena->adopt(*part.arena);
+  }
+  return p;
+}
@@ -0,0 +1,38 @@
+//----------------------------------------------------------------------
+// FILE: parallel_parser.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Multi-threaded parsing of programs with many definitions
+//----------------------------------------------------------------------
+
+#ifndef PARALLEL_PARSER_H
+#define PARALLEL_PARSER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "ast.h"
+#include "token_buffer.h"
+
+
+// programs with fewer than this many tokens per thread are parsed
+// serially
+const std::size_t PARALLEL_MIN_TOKENS = std::size_t(1) << 16;
+
+
+// Returns the index of the first token of each top-level struct and
+// function definition: a struct keyword, or the return type of an ID
+// followed by '(', outside of any braces
+std::vector<std::size_t> definition_starts(const TokenBuffer& tokens);
+
+
+// Parse the tokens into a program, splitting them at definition starts
+// into runs of definitions that are parsed concurrently (by up to
+// thread_count threads, or one per core if 0). The result, including
+// any error, is identical to ASTParser(tokens).parse().
+Program parse_parallel(std::shared_ptr<const TokenBuffer> tokens,
+                       unsigned thread_count = 0,
+                       std::size_t min_chunk = PARALLEL_MIN_TOKENS);
+
+
+#endif
@@ -0,0 +1,549 @@
+//----------------------------------------------------------------------
+// FILE: parser.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Recursive descent MyPL grammar (compiled once for each builder)
+//----------------------------------------------------------------------
+
+#include "parser.h"
+#include "simple_parser.h"
+#include "ast_parser.h"
+
+using namespace std;
+
+
+template<typename Builder>
+Parser<Builder>::Parser(const Lexer& a_lexer)
+  : tokens {a_lexer}
+{}
+
+
+template<typename Builder>
+Parser<Builder>::Parser(shared_ptr<const TokenBuffer> a_tokens)
+  : tokens {move(a_tokens)}
+{}
+
+
+template<typename Builder>
+Parser<Builder>::Parser(shared_ptr<const TokenBuffer> a_tokens, size_t first,
+                        size_t last)
+  : tokens {move(a_tokens), first, last}
+{}
+
+
+template<typename Builder>
+void Parser<Builder>::advance()
+{
+  tokens.advance();
+}
+
+
+template<typename Builder>
+void Parser<Builder>::eat(TokenType t, const char* msg)
+{
+  if (!match(t))
+    error(msg);
+  advance();
+}
+
+
+template<typename Builder>
+bool Parser<Builder>::match(TokenType t)
+{
+  return tokens.type() == t;
+}
+
+
+template<typename Builder>
+bool Parser<Builder>::match(initializer_list<TokenType> types)
+{
+  for (auto t : types)
+    if (match(t))
+      return true;
+  return false;
+}
+
+
+template<typename Builder>
+void Parser<Builder>::error(const string& msg)
+{
+  Token t = tokens.token();
+  string s = msg + " found '" + t.lexeme() + "' ";
+  s += "at line " + to_string(t.line()) + ", ";
+  s += "column " + to_string(t.column());
+  throw MyPLException::ParserError(s);
+}
+
+
+template<typename Builder>
+bool Parser<Builder>::bin_op()
+{
+  return match({TokenType::PLUS, TokenType::MINUS, TokenType::TIMES,
+      TokenType::DIVIDE, TokenType::AND, TokenType::OR, TokenType::EQUAL,
+      TokenType::LESS, TokenType::GREATER, TokenType::LESS_EQ,
+      TokenType::GREATER_EQ, TokenType::NOT_EQUAL});
+}
+
+
+// Takes in the function or struct and calls smaller methods to check they are correct
+template<typename Builder>
+typename Parser<Builder>::Program Parser<Builder>::parse()
+{
+  Program p = builder.program(tokens);
+  advance();
+  while (!match(TokenType::EOS)) {
+    if (match(TokenType::STRUCT))
+      struct_def(p);
+    else
+      fun_def(p);
+  }
+  eat(TokenType::EOS, "expecting end-of-file");
+  builder.end_program(p);
+  return p;
+}
+
+
+// Takes in the struct and calls smaller method for its fields
+template<typename Builder>
+void Parser<Builder>::struct_def(Program& p)
+{
+  StructDef& s = builder.struct_def(p); // built in place
+  eat(TokenType::STRUCT, "Expecting Structure");
+  builder.name(s, tokens);
+  eat(TokenType::ID, "Expecting ID");
+  eat(TokenType::LBRACE, "Expecting LBRACE");
+  fields(s); // inputs a structdef object to have its fields added
+  eat(TokenType::RBRACE, "Expecting RBRACE");
+}
+
+// Takes in the function and calls smaller methods for parameters, output type and statements
+template<typename Builder>
+void Parser<Builder>::fun_def(Program& p)
+{
+  FunDef& f = builder.fun_def(p); // built in place
+  if(!match(TokenType::VOID_TYPE))
+    data_type(builder.return_type(f));
+  else
+  {
+    builder.type_name(builder.return_type(f), tokens);
+    advance();
+  }
+  builder.name(f, tokens);
+  eat(TokenType::ID, "Expecting ID");
+  eat(TokenType::LPAREN, "Expecting LPAREN");
+  params(f); // inputs fundef to have parameters added
+  eat(TokenType::RPAREN, "Expecting RPAREN");
+  eat(TokenType::LBRACE, "Expecting LBRACE");
+  while(!match(TokenType::RBRACE))
+    stmt(builder.stmts(f)); // inputs fundef's stmts to have stmts added
+  eat(TokenType::RBRACE, "Expecting RBRACE");
+}
+
+// Finds the given fields for the struct
+template<typename Builder>
+void Parser<Builder>::fields(StructDef& s)
+{
+  if(!match(TokenType::RBRACE)) // adds var name and type for each varDef in field
+  {
+    VarDef& f = builder.field(s);
+    data_type(builder.data_type(f));
+    builder.name(f, tokens);
+    eat(TokenType::ID, "Expecting ID");
+    while(match(TokenType::COMMA))
+    {
+      VarDef& f = builder.field(s);
+      advance();
+      data_type(builder.data_type(f));
+      builder.name(f, tokens);
+      eat(TokenType::ID, "Expecting ID");
+    }
+  }
+}
+
+// Checks what kind of data type is being used
+template<typename Builder>
+void Parser<Builder>::data_type(DataType& f)
+{
+  if(match(TokenType::ID))
+  {
+    builder.type_name(f, tokens);
+    advance();
+  }
+  else if(match(TokenType::ARRAY))
+  {
+    builder.array_type(f);
+    advance();
+    if(match(TokenType::ID))
+    {
+      builder.type_name(f, tokens);
+      advance();
+    }
+    else
+    {
+      builder.type_name(f, tokens);
+      base_type();
+    }
+  }
+  else
+  {
+    builder.type_name(f, tokens);
+    base_type();
+  }
+}
+
+// Checks the type of base being used
+template<typename Builder>
+void Parser<Builder>::base_type()
+{
+  if(match(TokenType::INT_TYPE) || match(TokenType::DOUBLE_TYPE) || match(TokenType::STRING_TYPE) || match(TokenType::CHAR_TYPE) || match(TokenType::BOOL_TYPE))
+      advance();
+  else
+    error("Expecting Base Type");
+}
+
+// Finds what kind of statement is being used and calls the appropriate sub function
+template<typename Builder>
+void Parser<Builder>::stmt(StmtList& s)
+{
+  //adds the appropriate type of stmt to the list then fills it in the subfunction
+  if(match(TokenType::INT_TYPE) || match(TokenType::DOUBLE_TYPE) || match(TokenType::STRING_TYPE) || match(TokenType::CHAR_TYPE) || match(TokenType::BOOL_TYPE) || match(TokenType::ARRAY))
+    vdecl_stmt(builder.var_decl_stmt(s));
+  else if(match(TokenType::ID))// Since 3 statements start with ID it looks at the next token to differentiate them
+  {
+    TokenType next = tokens.peek(1);
+    if(next == TokenType::LPAREN)
+    {
+      CallExpr& c = builder.call_stmt(s);
+      builder.name(c, tokens);
+      advance();
+      call_expr(c);
+    }
+    else if(next == TokenType::ID)
+    {
+      VarDeclStmt& v = builder.var_decl_stmt(s);
+      builder.type_name(builder.data_type(builder.var_def(v)), tokens);
+      advance();
+      vdecl_stmt(v);
+    }
+    else
+    {
+      AssignStmt& a = builder.assign_stmt(s);
+      builder.path_name(builder.lvalue(a), tokens);
+      advance();
+      assign_stmt(a);
+    }
+  }
+  else if(match(TokenType::IF))
+    if_stmt(builder.if_stmt(s));
+  else if(match(TokenType::WHILE))
+    while_stmt(builder.while_stmt(s));
+  else if(match(TokenType::FOR))
+    for_stmt(builder.for_stmt(s));
+  else if(match(TokenType::RETURN))
+    ret_stmt(builder.return_stmt(s));
+  else if(match(TokenType::DELETE))
+    delete_stmt(builder.delete_stmt(s));
+  else
+    error("Expecting stmnt");
+}
+
+// Checks for a proper declaration of variable statement
+template<typename Builder>
+void Parser<Builder>::vdecl_stmt(VarDeclStmt& v)
+{
+  VarDef& d = builder.var_def(v);
+  if(!match(TokenType::ID))
+  {
+    data_type(builder.data_type(d));
+  }
+  builder.name(d, tokens);
+  eat(TokenType::ID, "Expecting ID");
+  eat(TokenType::ASSIGN, "Expecting ASSIGN");
+  expr(builder.expr(v));
+}
+
+// Checks for a proper assign statement
+template<typename Builder>
+void Parser<Builder>::assign_stmt(AssignStmt& a)
+{
+  lvalue(builder.lvalue(a));
+  eat(TokenType::ASSIGN, "Expecting ASSIGN");
+  expr(builder.expr(a));
+}
+
+template<typename Builder>
+void Parser<Builder>::delete_stmt(DeleteStmt& d)
+{
+  eat(TokenType::DELETE, "Expecting DELETE");
+  expr(builder.expr(d));
+}
+
+// Finds what kind of lvalue is occuring
+template<typename Builder>
+void Parser<Builder>::lvalue(Path& p)
+{
+  while(match(TokenType::DOT) || match(TokenType::LBRACKET))
+  {
+    if(match(TokenType::DOT))
+    {
+      advance();
+      builder.path_name(p, tokens);
+      eat(TokenType::ID, "Expecting ID");
+    }
+    else
+    {
+      advance();
+      expr(builder.index(p)); // index of the last name
+      eat(TokenType::RBRACKET, "Expecting RBRACKET");
+    }
+  }
+}
+
+// Checks that the if statement is correct
+template<typename Builder>
+void Parser<Builder>::if_stmt(IfStmt& i)
+{
+  eat(TokenType::IF, "Expecting IF");
+  eat(TokenType::LPAREN, "Expecting LPAREN");
+  BasicIf& b = builder.if_part(i);
+  expr(builder.condition(b));
+  eat(TokenType::RPAREN, "Expecting RPAREN");
+  eat(TokenType::LBRACE, "Expecting LBRACE");
+  while(!match(TokenType::RBRACE))
+  {
+    stmt(builder.stmts(b));
+  }
+  advance();
+  if_stmt_tail(i);
+}
+
+// Checks any else or else if statements after and if statement
+template<typename Builder>
+void Parser<Builder>::if_stmt_tail(IfStmt& i)
+{
+  if(match(TokenType::ELSEIF))
+  {
+    BasicIf& b = builder.else_if(i);
+    eat(TokenType::ELSEIF, "Expecting ELSEIF");
+    eat(TokenType::LPAREN, "Expecting LPAREN");
+    expr(builder.condition(b));
+    eat(TokenType::RPAREN, "Expecting RPAREN");
+    eat(TokenType::LBRACE, "Expecting LBRACE");
+    while(!match(TokenType::RBRACE))
+      stmt(builder.stmts(b));
+    advance();
+    if_stmt_tail(i);
+  }
+  else if(match(TokenType::ELSE))
+  {
+    advance();
+    eat(TokenType::LBRACE, "Expecting LBRACE");
+    while(!match(TokenType::RBRACE))
+      stmt(builder.else_stmts(i));
+    eat(TokenType::RBRACE, "Expecting RBRACE");
+  }
+}
+
+// Checks through the requirements for a while loop statement
+template<typename Builder>
+void Parser<Builder>::while_stmt(WhileStmt& w)
+{
+  eat(TokenType::WHILE, "Expecting WHILE");
+  eat(TokenType::LPAREN, "Expecting LPAREN");
+  expr(builder.condition(w));
+  eat(TokenType::RPAREN, "Expecting RPAREN");
+  eat(TokenType::LBRACE, "Expecting LBRACE");
+  while(!match(TokenType::RBRACE))
+    stmt(builder.stmts(w));
+  advance();
+}
+
+// Checks through the requirements for a for loop statement
+template<typename Builder>
+void Parser<Builder>::for_stmt(ForStmt& o)
+{
+  eat(TokenType::FOR, "Expecting FOR");
+  eat(TokenType::LPAREN, "Expecting LPAREN");
+  vdecl_stmt(builder.for_var_decl(o));
+  eat(TokenType::SEMICOLON, "Expecting SEMICOLON");
+  expr(builder.condition(o));
+  eat(TokenType::SEMICOLON, "Expecting SEMICOLON");
+  AssignStmt& a = builder.for_assign(o);
+  builder.path_name(builder.lvalue(a), tokens);
+  eat(TokenType::ID, "Expecting ID");
+  assign_stmt(a);
+  eat(TokenType::RPAREN, "Expecting RPAREN");
+  eat(TokenType::LBRACE, "Expecting LBRACE");
+  while(!match(TokenType::RBRACE))
+    stmt(builder.stmts(o));
+  advance();
+}
+
+// Checks for function call expressions
+template<typename Builder>
+void Parser<Builder>::call_expr(CallExpr& c)
+{
+  eat(TokenType::LPAREN, "Expecting LPAREN");
+  if(!match(TokenType::RPAREN))
+  {
+    expr(builder.arg(c));
+    while(match(TokenType::COMMA))
+    {
+      advance();
+      expr(builder.arg(c));
+    }
+  }
+  eat(TokenType::RPAREN, "Expecting RPAREN");
+}
+
+// Checks for return statement
+template<typename Builder>
+void Parser<Builder>::ret_stmt(ReturnStmt& r)
+{
+  eat(TokenType::RETURN, "Expecting RETURN");
+  expr(builder.expr(r));
+}
+
+// Parses the terms and operators of an expression in order (the
+// builder groups them, so long chains of operators take no extra
+// recursion), with parenthesized terms parsed by the same loop (so
+// deeply nested parentheses take none either)
+template<typename Builder>
+void Parser<Builder>::expr(Expr& e)
+{
+  auto mark = builder.begin_expr(e);
+  Expr* curr = &e; // innermost open parenthesized expression
+  size_t depth = 0; // number of open parentheses
+  while(true)
+  {
+    while(match(TokenType::NOT))
+    {
+      builder.negation(*curr);
+      advance();
+    }
+    if(match(TokenType::LPAREN))
+    {
+      curr = &builder.open_group(*curr);
+      ++depth;
+      advance();
+      continue;
+    }
+    rvalue(builder.simple_term(*curr));
+    // close the parentheses that end after this term
+    while((depth > 0) && !bin_op())
+    {
+      eat(TokenType::RPAREN, "Expecting RPAREN");
+      curr = &builder.close_group(*curr);
+      --depth;
+    }
+    if(!bin_op())
+      break;
+    builder.op(*curr, tokens);
+    advance();
+  }
+  builder.end_expr(e, mark);
+}
+
+// Finds what kind of rvalue is occuring
+template<typename Builder>
+void Parser<Builder>::rvalue(RValueSlot& r)
+{
+  if(match(TokenType::NULL_VAL))
+  {
+    builder.value(builder.simple_rvalue(r), tokens);
+    advance();
+  }
+  else if(match(TokenType::NEW))
+    new_rvalue(builder.new_rvalue(r));
+  else if(match(TokenType::ID))
+  {
+    if(tokens.peek(1) == TokenType::LPAREN)
+    {
+      CallExpr& c = builder.call_rvalue(r);
+      builder.name(c, tokens);
+      advance();
+      call_expr(c);
+    }
+    else
+    {
+      Path& p = builder.var_rvalue(r);
+      builder.path_name(p, tokens);
+      advance();
+      var_rvalue(p);
+    }
+  }
+  else
+    base_rvalue(builder.simple_rvalue(r));
+}
+
+// Parses for new rvalues
+template<typename Builder>
+void Parser<Builder>::new_rvalue(NewRValue& n)
+{
+  eat(TokenType::NEW, "Expecting NEW");
+  if(match(TokenType::ID))
+  {
+    builder.type(n, tokens);
+    eat(TokenType::ID, "Expecting ID");
+    if(match(TokenType::LBRACKET))
+    {
+      eat(TokenType::LBRACKET, "Expecting LBRACKET");
+      expr(builder.array_size(n));
+      eat(TokenType::RBRACKET, "Expecting RBRACKET");
+    }
+  }
+  else
+  {
+    builder.type(n, tokens);
+    base_type();
+    eat(TokenType::LBRACKET, "Expecting LBRACKET");
+    expr(builder.array_size(n));
+    eat(TokenType::RBRACKET, "Expecting RBRACKET");
+  }
+}
+
+// Finds the type of rvalue
+template<typename Builder>
+void Parser<Builder>::base_rvalue(SimpleRValue& r)
+{
+  if(match(TokenType::INT_VAL) || match(TokenType::DOUBLE_VAL) || match(TokenType::STRING_VAL) || match(TokenType::CHAR_VAL) || match(TokenType::BOOL_VAL))
+  {
+    builder.value(r, tokens);
+    advance();
+  }
+  else
+    error("Expecting Base VAL");
+}
+
+// Sees if anything needs to be added to var's ID in rvalue
+template<typename Builder>
+void Parser<Builder>::var_rvalue(Path& p)
+{
+  lvalue(p); // the same dotted and indexed path
+}
+
+// Finds the parameters within a function
+template<typename Builder>
+void Parser<Builder>::params(FunDef& f)
+{
+  if(!match(TokenType::RPAREN))
+  {
+    VarDef& s = builder.param(f);
+    data_type(builder.data_type(s));
+    builder.name(s, tokens);
+    eat(TokenType::ID, "Expecting ID");
+    while(match(TokenType::COMMA))
+    {
+      VarDef& s = builder.param(f);
+      advance();
+      data_type(builder.data_type(s));
+      builder.name(s, tokens);
+      eat(TokenType::ID, "Expecting ID");
+    }
+  }
+}
+
+
+// the syntax checker and the AST parser
+template class Parser<NullBuilder>;
+template class Parser<AstBuilder>;
@@ -0,0 +1,113 @@
+//----------------------------------------------------------------------
+// FILE: parser.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Recursive descent MyPL grammar, shared by the syntax checker
+//       and the AST parser
+//----------------------------------------------------------------------
+
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include "mypl_exception.h"
+#include "lexer.h"
+#include "token_buffer.h"
+#include "token_cursor.h"
+
+
+// A recursive descent parser for the MyPL grammar. The grammar only
+// recognizes the program; what is built from it is up to the Builder,
+// whose node types the grammar functions pass along and whose actions
+// they call as each part of the program is recognized (see NullBuilder
+// in simple_parser.h, which builds nothing, and AstBuilder in
+// ast_parser.h). The grammar is compiled once per builder in
+// parser.cpp.
+template<typename Builder>
+class Parser
+{
+public:
+
+  // the builder's node types
+  using Program = typename Builder::Program;
+  using StructDef = typename Builder::StructDef;
+  using FunDef = typename Builder::FunDef;
+  using VarDef = typename Builder::VarDef;
+  using DataType = typename Builder::DataType;
+  using StmtList = typename Builder::StmtList;
+  using VarDeclStmt = typename Builder::VarDeclStmt;
+  using AssignStmt = typename Builder::AssignStmt;
+  using IfStmt = typename Builder::IfStmt;
+  using BasicIf = typename Builder::BasicIf;
+  using WhileStmt = typename Builder::WhileStmt;
+  using ForStmt = typename Builder::ForStmt;
+  using ReturnStmt = typename Builder::ReturnStmt;
+  using DeleteStmt = typename Builder::DeleteStmt;
+  using CallExpr = typename Builder::CallExpr;
+  using Expr = typename Builder::Expr;
+  using RValueSlot = typename Builder::RValueSlot;
+  using NewRValue = typename Builder::NewRValue;
+  using SimpleRValue = typename Builder::SimpleRValue;
+  using Path = typename Builder::Path;
+
+  // crate a new recursive descent parer
+  Parser(const Lexer& lexer);
+
+  // create a parser over already lexed tokens
+  Parser(std::shared_ptr<const TokenBuffer> tokens);
+
+  // create a parser over the tokens [first, last) of a buffer, parsed as
+  // if they were the whole program (e.g., a run of its definitions)
+  Parser(std::shared_ptr<const TokenBuffer> tokens, std::size_t first,
+         std::size_t last);
+
+  // run the parser
+  Program parse();
+
+private:
+
+  // current token (and any lookahead)
+  TokenCursor tokens;
+  // what is built from the program
+  Builder builder;
+
+  // helper functions (eat only makes its message a string on an error,
+  // so checking syntax allocates nothing)
+  void advance();
+  void eat(TokenType t, const char* msg);
+  bool match(TokenType t);
+  bool match(std::initializer_list<TokenType> types);
+  void error(const std::string& msg);
+  bool bin_op();
+
+  // recursive descent functions
+  void struct_def(Program& p);
+  void fun_def(Program& p);
+  void fields(StructDef& s);
+  void data_type(DataType& f);
+  void base_type();
+  void stmt(StmtList& s);
+  void vdecl_stmt(VarDeclStmt& v);
+  void assign_stmt(AssignStmt& a);
+  void delete_stmt(DeleteStmt& d);
+  void lvalue(Path& p);
+  void if_stmt(IfStmt& i);
+  void if_stmt_tail(IfStmt& i);
+  void while_stmt(WhileStmt& w);
+  void for_stmt(ForStmt& o);
+  void call_expr(CallExpr& c);
+  void ret_stmt(ReturnStmt& r);
+  void expr(Expr& e);
+  void rvalue(RValueSlot& r);
+  void new_rvalue(NewRValue& n);
+  void base_rvalue(SimpleRValue& r);
+  void var_rvalue(Path& p);
+  void params(FunDef& f);
+
+};
+
+
+#endif
@@ -36,10 +36,11 @@ void PrintVisitor::print_indent()
 
 void PrintVisitor::visit(Program& p)
 {
-  for (auto struct_def : p.struct_defs)
-    struct_def.accept(*this);
-  for (auto fun_def : p.fun_defs)
-    fun_def.accept(*this);
+  source = p.source.get();
+  for (auto& struct_def : p.struct_defs)
+    visit(struct_def);
+  for (auto& fun_def : p.fun_defs)
+    visit(fun_def);
 }
 
 void PrintVisitor::visit(FunDef& f)
@@ -47,11 +48,11 @@ void PrintVisitor::visit(FunDef& f)
   out << endl;
   if(f.return_type.is_array)
   {
-    out << "array " << f.return_type.type_name << " " << f.fun_name.lexeme() << "(";
+    out << "array " << f.return_type.type_name << " " << f.fun_name.lexeme_view(*source) << "(";
   }
   else
   {
-    out << f.return_type.type_name << " " << f.fun_name.lexeme() << "(";
+    out << f.return_type.type_name << " " << f.fun_name.lexeme_view(*source) << "(";
   }
   for(int i = 0; i < f.params.size(); i++)
   {
@@ -59,7 +60,7 @@ void PrintVisitor::visit(FunDef& f)
     {
       out << "array ";
     }
-    out << f.params[i].data_type.type_name << " " <<f.params[i].var_name.lexeme();
+    out << f.params[i].data_type.type_name << " " <<f.params[i].var_name.lexeme_view(*source);
     if(!(f.params.size() == (i+1)))
     {
       out << ", ";
@@ -70,7 +71,7 @@ void PrintVisitor::visit(FunDef& f)
   for(int i = 0; i < f.stmts.size(); i++)
   {
     print_indent();
-    f.stmts[i]->accept(*this);
+    visit(*f.stmts[i]);
     out << endl;
   }
   dec_indent();
@@ -83,7 +84,7 @@ void PrintVisitor::visit(FunDef& f)
 void PrintVisitor::visit(StructDef& s)
 {
   out << endl;
-  out << "struct " << s.struct_name.lexeme() << " {" << endl;
+  out << "struct " << s.struct_name.lexeme_view(*source) << " {" << endl;
   inc_indent();
   for(int i = 0; i < s.fields.size(); i++)
   {
@@ -92,7 +93,7 @@ void PrintVisitor::visit(StructDef& s)
     {
       out << "array ";
     }
-    out << s.fields[i].data_type.type_name << " " <<s.fields[i].var_name.lexeme();
+    out << s.fields[i].data_type.type_name << " " <<s.fields[i].var_name.lexeme_view(*source);
     if(!(s.fields.size() == (i+1)))
     {
       out << ",\n";
@@ -106,25 +107,25 @@ void PrintVisitor::visit(StructDef& s)
 void PrintVisitor::visit(ReturnStmt& s)
 {
   out << "return ";
-  s.expr.accept(*this);
+  visit(s.expr);
 }
 
 void PrintVisitor::visit(DeleteStmt& s)
 {
   out << "delete ";
-  s.expr.accept(*this);
+  visit(s.expr);
 }
 
 void PrintVisitor::visit(WhileStmt& s)
 {
   out << "while (";
   inc_indent();
-  s.condition.accept(*this);
+  visit(s.condition);
   out << ") {\n";
   for(int i = 0; i < s.stmts.size(); i++)
   {
     print_indent();
-    s.stmts[i]->accept(*this);
+    visit(*s.stmts[i]);
     out << endl;
   }
   dec_indent();
@@ -136,17 +137,17 @@ void PrintVisitor::visit(WhileStmt& s)
 void PrintVisitor::visit(ForStmt& s)
 {
   out << "for (";
-  s.var_decl.accept(*this);
+  visit(s.var_decl);
   out << "; ";
-  s.condition.accept(*this);
+  visit(s.condition);
   out << "; ";
-  s.assign_stmt.accept(*this);
+  visit(s.assign_stmt);
   out << ") {\n";
   inc_indent();
   for(int i = 0; i < s.stmts.size(); i++)
   {
     print_indent();
-    s.stmts[i]->accept(*this);
+    visit(*s.stmts[i]);
     out << endl;
   }
   dec_indent();
@@ -157,13 +158,13 @@ void PrintVisitor::visit(ForStmt& s)
 void PrintVisitor::visit(IfStmt& s)
 {
   out << "if (";
-  s.if_part.condition.accept(*this);
+  visit(s.if_part.condition);
   out << ") {\n";
   inc_indent();
   for(int i = 0; i < s.if_part.stmts.size(); i++)
   {
     print_indent();
-    s.if_part.stmts[i]->accept(*this);
+    visit(*s.if_part.stmts[i]);
     out << endl;
   }
   dec_indent();
@@ -176,13 +177,13 @@ void PrintVisitor::visit(IfStmt& s)
     {
       print_indent();
       out << "elseif (";
-      s.else_ifs[i].condition.accept(*this);
+      visit(s.else_ifs[i].condition);
       out << ") {\n";
       inc_indent();
       for(int j = 0; j < s.else_ifs[i].stmts.size(); j++)
       {
         print_indent();
-        s.else_ifs[i].stmts[j]->accept(*this);
+        visit(*s.else_ifs[i].stmts[j]);
         out << endl;
       }
       dec_indent();
@@ -202,7 +203,7 @@ void PrintVisitor::visit(IfStmt& s)
     for(int i = 0; i < s.else_stmts.size(); i++)
     {
       print_indent();
-      s.else_stmts[i]->accept(*this);
+      visit(*s.else_stmts[i]);
       out << endl;
     }
     dec_indent();
@@ -213,19 +214,19 @@ void PrintVisitor::visit(IfStmt& s)
 
 void PrintVisitor::visit(VarDeclStmt& s)
 {
-  out << s.var_def.data_type.type_name << " " << s.var_def.var_name.lexeme() << " = ";
-  s.expr.accept(*this);
+  out << s.var_def.data_type.type_name << " " << s.var_def.var_name.lexeme_view(*source) << " = ";
+  visit(s.expr);
 }
 
 void PrintVisitor::visit(AssignStmt& s)
 {
   for(int i = 0; i < s.lvalue.size(); i++)
   {
-    out << s.lvalue[i].var_name.lexeme();
+    out << s.lvalue[i].var_name.lexeme_view(*source);
     if(s.lvalue[i].array_expr.has_value())
     {
       out << "[";
-      s.lvalue[i].array_expr->accept(*this);
+      visit(*s.lvalue[i].array_expr);
       out << "]";
     }
     if(!(s.lvalue.size() == (i+1)))
@@ -234,15 +235,15 @@ void PrintVisitor::visit(AssignStmt& s)
     }
   }
   out << " = ";
-  s.expr.accept(*this);
+  visit(s.expr);
 }
 
 void PrintVisitor::visit(CallExpr& e)
 {
-  out << e.fun_name.lexeme() << "(";
+  out << e.fun_name.lexeme_view(*source) << "(";
   for(int i = 0; i < e.args.size(); i++)
   {
-    e.args[i].accept(*this);
+    visit(e.args[i]);
     if(!(e.args.size() == (i+1)))
     {
       out << ", ";
@@ -253,33 +254,39 @@ void PrintVisitor::visit(CallExpr& e)
 
 void PrintVisitor::visit(Expr& e)
 {
-  if(e.negated)
+  // prints the terms and operators in source order (a 'not' covers the
+  // rest of the expression)
+  size_t next_negation = 0;
+  for(size_t i = 0; i <= e.rest.size(); i++)
   {
-    out << "not ("; 
-  }
-  e.first->accept(*this);
-  if(e.op.has_value())
-  {
-    out << " ";
-    out << e.op.value().lexeme();
-    out << " ";
-    e.rest->accept(*this);
+    if(i > 0)
+    {
+      out << " ";
+      out << e.rest[i - 1].op.lexeme_view(*source);
+      out << " ";
+    }
+    if((next_negation < e.negations.size()) && (e.negations[next_negation] == i))
+    {
+      out << "not (";
+      next_negation++;
+    }
+    visit(*e.term(i));
   }
-  if(e.negated)
+  for(size_t i = 0; i < e.negations.size(); i++)
   {
-    out << ")"; 
+    out << ")";
   }
 }
 
 void PrintVisitor::visit(SimpleTerm& t)
 {
-  t.rvalue->accept(*this);
+  visit(*t.rvalue);
 }
 
 void PrintVisitor::visit(ComplexTerm& t)
 {
   out << "(";
-  t.expr.accept(*this);
+  visit(t.expr);
   out << ")";
 }
 
@@ -287,25 +294,25 @@ void PrintVisitor::visit(SimpleRValue& v)
 {
   if(v.first_token().type() == TokenType::STRING_VAL)
   {
-    out << "\"" << v.value.lexeme() << "\"";
+    out << "\"" << v.value.lexeme_view(*source) << "\"";
   }
   else if(v.first_token().type() == TokenType::CHAR_VAL)
   {
-    out << "\'" << v.value.lexeme() << "\'";
+    out << "\'" << v.value.lexeme_view(*source) << "\'";
   }
   else
   {
-    out << v.value.lexeme();
+    out << v.value.lexeme_view(*source);
   }
 }
 
 void PrintVisitor::visit(NewRValue& v)
 {
-  out << "new " << v.type.lexeme();
+  out << "new " << v.type.lexeme_view(*source);
   if(v.array_expr.has_value())
   {
     out << " [";
-    v.array_expr->accept(*this);
+    visit(*v.array_expr);
     out << "]";
   }
 }
@@ -314,11 +321,11 @@ void PrintVisitor::visit(VarRValue& v)
 {
   for(int i = 0; i < v.path.size(); i++)
   {
-    out << v.path[i].var_name.lexeme();
+    out << v.path[i].var_name.lexeme_view(*source);
     if(v.path[i].array_expr.has_value())
     {
       out << "[";
-      v.path[i].array_expr->accept(*this);
+      visit(*v.path[i].array_expr);
       out << "]";
     }
     if(!(v.path.size() == (i+1)))
@@ -13,7 +13,7 @@
 #include "ast.h"
 
 
-class PrintVisitor : public Visitor {
+class PrintVisitor final : public Visitor {
 public:
   PrintVisitor(std::ostream& output);
   void visit(Program& p);
@@ -35,12 +35,20 @@ public:
   void visit(VarRValue& v);    
 private:
   std::ostream& out;  
+  // source of the program being printed (which its tokens refer to)
+  const SourceBuffer* source = nullptr;
   int indent = 0;
   const int INDENT_AMT = 2;
 
   void inc_indent();
   void dec_indent();
   void print_indent();
+
+  // visit the statement, term, or rvalue as its own node type (by
+  // switching on its kind rather than through accept)
+  void visit(Stmt& s) {dispatch(s, [this](auto& n) {visit(n);});}
+  void visit(ExprTerm& t) {dispatch(t, [this](auto& n) {visit(n);});}
+  void visit(RValue& v) {dispatch(v, [this](auto& n) {visit(n);});}
   
 };
 
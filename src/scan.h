@@ -0,0 +1,214 @@
+//----------------------------------------------------------------------
+// FILE: scan.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Block-at-a-time (SSE2/AVX2) character scanning kernels used by
+//       the lexer, with a scalar fallback
+//----------------------------------------------------------------------
+
+#ifndef SCAN_H
+#define SCAN_H
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+//----------------------------------------------------------------------
+// Vector primitives (one block is SCAN_WIDTH bytes)
+//----------------------------------------------------------------------
+
+#if defined(__AVX2__)
+
+#define SCAN_WIDTH 32
+typedef __m256i ScanBlock;
+
+inline ScanBlock scan_load(const char* p)
+{
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+inline ScanBlock scan_splat(char c) { return _mm256_set1_epi8(c); }
+inline ScanBlock scan_eq(ScanBlock a, ScanBlock b)
+{
+  return _mm256_cmpeq_epi8(a, b);
+}
+inline ScanBlock scan_gt(ScanBlock a, ScanBlock b)
+{
+  return _mm256_cmpgt_epi8(a, b);
+}
+inline ScanBlock scan_and(ScanBlock a, ScanBlock b)
+{
+  return _mm256_and_si256(a, b);
+}
+inline ScanBlock scan_or(ScanBlock a, ScanBlock b)
+{
+  return _mm256_or_si256(a, b);
+}
+inline uint32_t scan_bits(ScanBlock a)
+{
+  return static_cast<uint32_t>(_mm256_movemask_epi8(a));
+}
+const uint32_t SCAN_ALL = 0xFFFFFFFFu;
+
+#elif defined(__SSE2__)
+
+#define SCAN_WIDTH 16
+typedef __m128i ScanBlock;
+
+inline ScanBlock scan_load(const char* p)
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+inline ScanBlock scan_splat(char c) { return _mm_set1_epi8(c); }
+inline ScanBlock scan_eq(ScanBlock a, ScanBlock b)
+{
+  return _mm_cmpeq_epi8(a, b);
+}
+inline ScanBlock scan_gt(ScanBlock a, ScanBlock b)
+{
+  return _mm_cmpgt_epi8(a, b);
+}
+inline ScanBlock scan_and(ScanBlock a, ScanBlock b)
+{
+  return _mm_and_si128(a, b);
+}
+inline ScanBlock scan_or(ScanBlock a, ScanBlock b)
+{
+  return _mm_or_si128(a, b);
+}
+inline uint32_t scan_bits(ScanBlock a)
+{
+  return static_cast<uint32_t>(_mm_movemask_epi8(a));
+}
+const uint32_t SCAN_ALL = 0xFFFFu;
+
+#endif
+
+#ifdef SCAN_WIDTH
+
+// lanes in [lo, hi] (signed compares, so bytes >= 0x80 never match)
+inline ScanBlock scan_range(ScanBlock v, char lo, char hi)
+{
+  return scan_and(scan_gt(v, scan_splat(lo - 1)),
+                  scan_gt(scan_splat(hi + 1), v));
+}
+
+// space, \t, \n, \v, \f, \r
+inline ScanBlock scan_blank_lanes(ScanBlock v)
+{
+  return scan_or(scan_eq(v, scan_splat(' ')), scan_range(v, '\t', '\r'));
+}
+
+// letters, digits, and underscores
+inline ScanBlock scan_word_lanes(ScanBlock v)
+{
+  ScanBlock lower = scan_or(v, scan_splat(0x20));
+  return scan_or(scan_or(scan_range(v, '0', '9'), scan_range(lower, 'a', 'z')),
+                 scan_eq(v, scan_splat('_')));
+}
+
+#endif
+
+
+//----------------------------------------------------------------------
+// Kernels
+//----------------------------------------------------------------------
+
+// Skips whitespace (including newlines) starting at p and returns the
+// first non-whitespace position (or end)
+inline const char* scan_blank(const char* p, const char* end)
+{
+#ifdef SCAN_WIDTH
+  while (end - p >= SCAN_WIDTH) {
+    uint32_t stop = ~scan_bits(scan_blank_lanes(scan_load(p))) & SCAN_ALL;
+    if (stop)
+      return p + std::countr_zero(stop);
+    p += SCAN_WIDTH;
+  }
+#endif
+  while ((p != end) && ((*p == ' ') || ((*p >= '\t') && (*p <= '\r'))))
+    ++p;
+  return p;
+}
+
+// Returns the first '\n' at or after p (or end), e.g., the end of a
+// comment
+inline const char* scan_newline(const char* p, const char* end)
+{
+#ifdef SCAN_WIDTH
+  while (end - p >= SCAN_WIDTH) {
+    uint32_t hit = scan_bits(scan_eq(scan_load(p), scan_splat('\n')));
+    if (hit)
+      return p + std::countr_zero(hit);
+    p += SCAN_WIDTH;
+  }
+#endif
+  while ((p != end) && (*p != '\n'))
+    ++p;
+  return p;
+}
+
+// Returns the first '"' or '\n' at or after p (or end), i.e., where a
+// string literal's body stops
+inline const char* scan_string_body(const char* p, const char* end)
+{
+#ifdef SCAN_WIDTH
+  while (end - p >= SCAN_WIDTH) {
+    ScanBlock v = scan_load(p);
+    uint32_t hit = scan_bits(scan_or(scan_eq(v, scan_splat('"')),
+                                     scan_eq(v, scan_splat('\n'))));
+    if (hit)
+      return p + std::countr_zero(hit);
+    p += SCAN_WIDTH;
+  }
+#endif
+  while ((p != end) && (*p != '"') && (*p != '\n'))
+    ++p;
+  return p;
+}
+
+// Returns the first position at or after p that cannot continue an
+// identifier or reserved word (or end)
+inline const char* scan_word(const char* p, const char* end)
+{
+#ifdef SCAN_WIDTH
+  while (end - p >= SCAN_WIDTH) {
+    uint32_t stop = ~scan_bits(scan_word_lanes(scan_load(p))) & SCAN_ALL;
+    if (stop)
+      return p + std::countr_zero(stop);
+    p += SCAN_WIDTH;
+  }
+#endif
+  for (; p != end; ++p) {
+    char c = *p;
+    char lower = c | 0x20;
+    if (!(((c >= '0') && (c <= '9')) || ((lower >= 'a') && (lower <= 'z')) ||
+          (c == '_')))
+      break;
+  }
+  return p;
+}
+
+// Returns the first non-digit at or after p (or end)
+inline const char* scan_digits(const char* p, const char* end)
+{
+#ifdef SCAN_WIDTH
+  while (end - p >= SCAN_WIDTH) {
+    uint32_t stop = ~scan_bits(scan_range(scan_load(p), '0', '9')) & SCAN_ALL;
+    if (stop)
+      return p + std::countr_zero(stop);
+    p += SCAN_WIDTH;
+  }
+#endif
+  while ((p != end) && (*p >= '0') && (*p <= '9'))
+    ++p;
+  return p;
+}
+
+
+#endif
@@ -18,24 +18,55 @@ const unordered_set<string> BASE_TYPES {"int", "double", "char", "string", "bool
 const unordered_set<string> BUILT_INS {"print", "input", "to_string",  "to_int",
   "to_double", "length", "get", "concat"};
 
+// interned name of the symbol table entry holding a function's return type
+const SymbolId RETURN_SYMBOL = Interner::global().intern("return");
+
 
 // helper functions
 
-optional<VarDef> SemanticChecker::get_field(const StructDef& struct_def,
-                                            const string& field_name)
+optional<VarDef> SemanticChecker::get_field(const StructDef* struct_def,
+                                            SymbolId field_name)
 {
-  for (const VarDef& var_def : struct_def.fields)
-    if (var_def.var_name.lexeme() == field_name)
+  if (!struct_def)
+    return nullopt;
+  for (const VarDef& var_def : struct_def->fields)
+    if (var_def.var_name.symbol() == field_name)
       return var_def;
   return nullopt;
 }
 
 
-void SemanticChecker::error(const string& msg, const Token& token)
+SymbolId SemanticChecker::type_symbol(const string& type_name) const
+{
+  return Interner::global().find(type_name);
+}
+
+
+void SemanticChecker::record_type(NodeId id)
+{
+  // runs of nodes mostly share a type (e.g., a term and its rvalue)
+  const DataType& last = found_types[last_type_index];
+  if((last.is_array != curr_type.is_array) || (last.type_name != curr_type.type_name))
+  {
+    TypeIndex& index = type_index_by_name[curr_type.type_name];
+    uint32_t& i = curr_type.is_array ? index.array : index.plain;
+    if(i == 0)
+    {
+      i = found_types.size();
+      found_types.push_back(curr_type);
+    }
+    last_type_index = i;
+  }
+  type_indexes[id] = last_type_index;
+}
+
+
+void SemanticChecker::error(const string& msg, TokenRef ref)
 {
+  SourcePosition pos = ref.position(*source);
   string s = msg;
-  s += " near line " + to_string(token.line()) + ", ";
-  s += "column " + to_string(token.column());
+  s += " near line " + to_string(pos.line) + ", ";
+  s += "column " + to_string(pos.column);
   throw MyPLException::StaticError(s);
 }
 
@@ -57,20 +88,33 @@ void SemanticChecker::error(const string& msg)
  */
 void SemanticChecker::visit(Program& p)
 {
+  // forget any program checked before (and an error may have left
+  // environments and expressions behind)
+  source = p.source.get();
+  symbol_table = SymbolTable();
+  struct_defs.clear();
+  fun_defs.clear();
+  expr_types.clear();
+  expr_first_terms.clear();
+  expr_frames.clear();
+  type_indexes = NodeTable<uint32_t>(p);
+  found_types.assign(1, DataType {});
+  type_index_by_name.clear();
+  last_type_index = 0;
   // record each struct def
   for (StructDef& d : p.struct_defs) {
-    string name = d.struct_name.lexeme();
-    if (struct_defs.contains(name))
+    string name = d.struct_name.lexeme(*source);
+    if (struct_defs.contains(d.struct_name.symbol()))
       error("multiple definitions of '" + name + "'", d.struct_name);
-    struct_defs[name] = d;
+    struct_defs[d.struct_name.symbol()] = &d;
   }
   // record each function def (need a main function)
   bool found_main = false;
   for (FunDef& f : p.fun_defs) {
-    string name = f.fun_name.lexeme();
+    string name = f.fun_name.lexeme(*source);
     if (BUILT_INS.contains(name))
       error("redefining built-in function '" + name + "'", f.fun_name);
-    if (fun_defs.contains(name))
+    if (fun_defs.contains(f.fun_name.symbol()))
       error("multiple definitions of '" + name + "'", f.fun_name);
     if (name == "main") {
       if (f.return_type.type_name != "void")
@@ -79,16 +123,16 @@ void SemanticChecker::visit(Program& p)
         error("main function cannot have parameters", f.params[0].var_name);
       found_main = true;
     }
-    fun_defs[name] = f;
+    fun_defs[f.fun_name.symbol()] = &f;
   }
   if (!found_main)
     error("program missing main function");
   // check each struct
   for (StructDef& d : p.struct_defs)
-    d.accept(*this);
+    visit(d);
   // check each function
   for (FunDef& d : p.fun_defs)
-    d.accept(*this);
+    visit(d);
 }
 
 
@@ -106,6 +150,7 @@ void SemanticChecker::visit(SimpleRValue& v)
     curr_type = DataType {false, "bool"};    
   else if (v.value.type() == TokenType::NULL_VAL)
     curr_type = DataType {false, "void"};    
+  record_type(v.id);
 }
 
 
@@ -130,7 +175,7 @@ void SemanticChecker::visit(FunDef& f)
   {
     if((f.params[i].data_type.type_name != "int") && (f.params[i].data_type.type_name != "double") && (f.params[i].data_type.type_name != "char") && (f.params[i].data_type.type_name != "string") && (f.params[i].data_type.type_name != "bool"))
     {
-      if(!symbol_table.name_exists(f.params[i].data_type.type_name) && !(struct_defs.contains(f.params[i].data_type.type_name)))
+      if(!symbol_table.name_exists(f.params[i].data_type.type_name) && !(struct_defs.contains(type_symbol(f.params[i].data_type.type_name))))
       {
         error("invalid parameter type '" + f.params[i].data_type.type_name + "'", f.params[i].var_name);
       }
@@ -138,23 +183,23 @@ void SemanticChecker::visit(FunDef& f)
     //check params are different
     for(int j = i + 1; j < f.params.size(); j++)
     {
-      if(f.params[i].var_name.lexeme() == f.params[j].var_name.lexeme())
+      if(f.params[i].var_name.symbol() == f.params[j].var_name.symbol())
       {
-        error("Multiple parameters of name '" + f.params[i].var_name.lexeme() + "'", f.params[i].var_name);
+        error("Multiple parameters of name '" + f.params[i].var_name.lexeme(*source) + "'", f.params[i].var_name);
       }
     }
   }
   symbol_table.push_environment();
-  symbol_table.add("return", return_type);
+  symbol_table.add(RETURN_SYMBOL, return_type);
   //add parameter name to enviroment 
   for(int i = 0; i < f.params.size(); i++)
   {
-    symbol_table.add(f.params[i].var_name.lexeme(), f.params[i].data_type);
+    symbol_table.add(f.params[i].var_name.symbol(), f.params[i].data_type);
   }
   //loop stmts
   for(auto s : f.stmts)
   {
-    s->accept(*this);
+    visit(*s);
   }
   //pop environment
   symbol_table.pop_environment();
@@ -172,7 +217,7 @@ void SemanticChecker::visit(StructDef& s)
     {
       if((s.fields[i].data_type.type_name != "int") && (s.fields[i].data_type.type_name != "double") && (s.fields[i].data_type.type_name != "char") && (s.fields[i].data_type.type_name != "string") && (s.fields[i].data_type.type_name != "bool"))
       {
-        if(!(symbol_table.name_exists(s.fields[i].data_type.type_name)) && !(struct_defs.contains(s.fields[i].data_type.type_name)))
+        if(!(symbol_table.name_exists(s.fields[i].data_type.type_name)) && !(struct_defs.contains(type_symbol(s.fields[i].data_type.type_name))))
         {
           error("invalid struct type '" + s.fields[i].data_type.type_name + "'", s.fields[i].var_name);
         }
@@ -180,9 +225,9 @@ void SemanticChecker::visit(StructDef& s)
       //check fields are different
       for(int j = i + 1; j < s.fields.size(); j++)
       {
-        if(s.fields[i].var_name.lexeme() == s.fields[j].var_name.lexeme())
+        if(s.fields[i].var_name.symbol() == s.fields[j].var_name.symbol())
         {
-          error("Multiple structs of name '" + s.fields[i].var_name.lexeme() + "'", s.fields[i].var_name);
+          error("Multiple structs of name '" + s.fields[i].var_name.lexeme(*source) + "'", s.fields[i].var_name);
         }
       }
     }
@@ -190,7 +235,7 @@ void SemanticChecker::visit(StructDef& s)
   //add fields name to enviroment 
   for(int i = 0; i < s.fields.size(); i++)
   {
-    symbol_table.add(s.fields[i].var_name.lexeme(), s.fields[i].data_type);
+    symbol_table.add(s.fields[i].var_name.symbol(), s.fields[i].data_type);
   }
   //pop environment
   symbol_table.pop_environment();
@@ -205,9 +250,9 @@ void SemanticChecker::visit(StructDef& s)
  */
 void SemanticChecker::visit(ReturnStmt& s)
 {
-  s.expr.accept(*this);
-  DataType expected_type = symbol_table.get("return").value();
-  if((symbol_table.get("return")->type_name != curr_type.type_name) && (curr_type.type_name != "void"))
+  visit(s.expr);
+  DataType expected_type = symbol_table.get(RETURN_SYMBOL).value();
+  if((expected_type.type_name != curr_type.type_name) && (curr_type.type_name != "void"))
   {
     error("Type mismatch returning " + curr_type.type_name + " when expected " + expected_type.type_name, s.expr.first_token());
   }
@@ -215,19 +260,11 @@ void SemanticChecker::visit(ReturnStmt& s)
 
 void SemanticChecker::visit(DeleteStmt& s)
 {
-  s.expr.accept(*this);
-  if(!(struct_defs.contains(curr_type.type_name)) && !(curr_type.is_array))
+  visit(s.expr);
+  if(!(struct_defs.contains(type_symbol(curr_type.type_name))) && !(curr_type.is_array))
   {
     error("Invalid type " + curr_type.type_name + " when expected struct or array", s.expr.first_token());
   }
-  else if(struct_defs.contains(curr_type.type_name))
-  {
-    struct_defs[curr_type.type_name] = NULL;
-  }
-  else
-  {
-    
-  }
 }
 
 
@@ -240,14 +277,14 @@ void SemanticChecker::visit(DeleteStmt& s)
 void SemanticChecker::visit(WhileStmt& s)
 {
   symbol_table.push_environment();
-  s.condition.accept(*this);
+  visit(s.condition);
   if((curr_type.type_name != "bool") || (curr_type.is_array))
   {
     error("Type mismatch", s.condition.first_token());
   }
   for(auto t : s.stmts)
   {
-    t->accept(*this);
+    visit(*t);
   }
   symbol_table.pop_environment();
 }
@@ -262,16 +299,16 @@ void SemanticChecker::visit(WhileStmt& s)
 void SemanticChecker::visit(ForStmt& s)
 {
   symbol_table.push_environment();
-  s.var_decl.accept(*this);
-  s.condition.accept(*this);
+  visit(s.var_decl);
+  visit(s.condition);
   if((curr_type.type_name != "bool") || (curr_type.is_array))
   {
     error("Type mismatch", s.condition.first_token());
   }
-  s.assign_stmt.accept(*this);
+  visit(s.assign_stmt);
   for(auto t : s.stmts)
   {
-    t->accept(*this);
+    visit(*t);
   }
   symbol_table.pop_environment();
 }
@@ -286,34 +323,34 @@ void SemanticChecker::visit(ForStmt& s)
 void SemanticChecker::visit(IfStmt& s)
 {
   symbol_table.push_environment();
-  s.if_part.condition.accept(*this);
+  visit(s.if_part.condition);
   if(curr_type.type_name != "bool" || curr_type.is_array)
   {
     error("Type mismatch must have a bool in if condition");
   }
   for(auto t : s.if_part.stmts)
   {
-    t->accept(*this);
+    visit(*t);
   }
   symbol_table.pop_environment();
-  for(auto e : s.else_ifs)
+  for(auto& e : s.else_ifs)
   {
     symbol_table.push_environment();
-    e.condition.accept(*this);
+    visit(e.condition);
     if(curr_type.type_name != "bool" || curr_type.is_array)
     {
       error("Type mismatch must have a bool in if condition");
     }
     for(int i = 0; i < e.stmts.size(); i++)
     {
-      e.stmts[i]->accept(*this);
+      visit(*e.stmts[i]);
     }
     symbol_table.pop_environment();
   }
   symbol_table.push_environment();
   for(auto e : s.else_stmts)
   {
-    e->accept(*this);
+    visit(*e);
   }
   symbol_table.pop_environment();
 } 
@@ -327,7 +364,7 @@ void SemanticChecker::visit(VarDeclStmt& s)
 {
   if((s.var_def.data_type.type_name != "int") && (s.var_def.data_type.type_name != "double") && (s.var_def.data_type.type_name != "char") && (s.var_def.data_type.type_name != "string") && (s.var_def.data_type.type_name != "bool"))
     {
-      if(!(symbol_table.name_exists(s.var_def.data_type.type_name)) && !(struct_defs.contains(s.var_def.data_type.type_name)))
+      if(!(symbol_table.name_exists(s.var_def.data_type.type_name)) && !(struct_defs.contains(type_symbol(s.var_def.data_type.type_name))))
         {
           error("invalid variable declaration type '" + s.var_def.data_type.type_name + "'", s.var_def.var_name);
         }
@@ -336,12 +373,12 @@ void SemanticChecker::visit(VarDeclStmt& s)
   {
     curr_type = DataType {true, s.var_def.data_type.type_name};
   }
-  if(symbol_table.name_exists_in_curr_env(s.var_def.var_name.lexeme()))
+  if(symbol_table.name_exists_in_curr_env(s.var_def.var_name.symbol()))
   {
-    error("Multiple vars of name '" + s.var_def.var_name.lexeme() + "' in current in enviroment", s.var_def.var_name);
+    error("Multiple vars of name '" + s.var_def.var_name.lexeme(*source) + "' in current in enviroment", s.var_def.var_name);
   }
-  symbol_table.add(s.var_def.var_name.lexeme(), s.var_def.data_type);
-  s.expr.accept(*this);
+  symbol_table.add(s.var_def.var_name.symbol(), s.var_def.data_type);
+  visit(s.expr);
   if(((curr_type.type_name != s.var_def.data_type.type_name) && (curr_type.type_name != "void")))
     {
       if(s.var_def.data_type.is_array)
@@ -364,11 +401,11 @@ void SemanticChecker::visit(VarDeclStmt& s)
  */
 void SemanticChecker::visit(AssignStmt& s)
 {
-  s.expr.accept(*this);
+  visit(s.expr);
   DataType rhs = curr_type;
   if(s.lvalue.size() < 2)
   {
-    DataType lhs = *symbol_table.get(s.lvalue[0].var_name.lexeme()); 
+    DataType lhs = *symbol_table.get(s.lvalue[0].var_name.symbol()); 
     if((curr_type.type_name != lhs.type_name))
     {
       error("Type mismatch", s.lvalue[0].var_name);
@@ -376,17 +413,17 @@ void SemanticChecker::visit(AssignStmt& s)
   }
   else
   {
-   string var_name = s.lvalue[0].var_name.lexeme();
+   SymbolId var_name = s.lvalue[0].var_name.symbol();
    if(symbol_table.name_exists(var_name))
    {
     DataType d = symbol_table.get(var_name).value();
     curr_type = DataType(symbol_table.get(var_name)->is_array, symbol_table.get(var_name).value().type_name);
-    if(struct_defs.contains(curr_type.type_name))
+    if(struct_defs.contains(type_symbol(curr_type.type_name)))
     {
       for(int i = 1; i < s.lvalue.size(); i++)
       {
-        string var_name2 = s.lvalue[i].var_name.lexeme();
-        VarDef field = get_field(struct_defs[curr_type.type_name], var_name2).value();
+        SymbolId var_name2 = s.lvalue[i].var_name.symbol();
+        VarDef field = get_field(struct_defs[type_symbol(curr_type.type_name)], var_name2).value();
         curr_type = {field.data_type.is_array, field.data_type.type_name};
       }
     }
@@ -411,15 +448,15 @@ void SemanticChecker::visit(AssignStmt& s)
  */
 void SemanticChecker::visit(CallExpr& e)
 {
-  string fun_name = e.fun_name.lexeme();
+  string_view fun_name = e.fun_name.lexeme_view(*source);
   if(fun_name == "print")
   {
     if(!(e.args.size() == 1))
     {
       error("Invalid number of parameters", e.first_token());
     }
-    e.args[0].accept(*this);
-    if(struct_defs.contains(curr_type.type_name))
+    visit(e.args[0]);
+    if(struct_defs.contains(type_symbol(curr_type.type_name)))
     {
       error("Cannot print type struct", e.first_token());
     }
@@ -435,12 +472,12 @@ void SemanticChecker::visit(CallExpr& e)
     {
       error("Invalid number of parameters", e.first_token());
     }
-    e.args[0].accept(*this);
+    visit(e.args[0]);
     if((curr_type.type_name != "int") || (curr_type.is_array))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
     }
-    e.args[1].accept(*this);
+    visit(e.args[1]);
     if((curr_type.type_name != "string") || (curr_type.is_array))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
@@ -453,7 +490,7 @@ void SemanticChecker::visit(CallExpr& e)
     {
       error("Invalid number of parameters", e.first_token());
     }
-    e.args[0].accept(*this);
+    visit(e.args[0]);
     if((curr_type.type_name == "void") || (curr_type.type_name == "bool") || (curr_type.is_array))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
@@ -474,7 +511,7 @@ void SemanticChecker::visit(CallExpr& e)
     {
       error("Invalid number of parameters", e.first_token());
     }
-    e.args[0].accept(*this);
+    visit(e.args[0]);
     if((curr_type.type_name == "void") || (curr_type.type_name == "bool") || (curr_type.is_array) || (curr_type.type_name == "int"))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
@@ -487,7 +524,7 @@ void SemanticChecker::visit(CallExpr& e)
     {
       error("Invalid number of parameters", e.first_token());
     }
-    e.args[0].accept(*this);
+    visit(e.args[0]);
     if((curr_type.type_name == "void") || (curr_type.type_name == "bool") || (curr_type.is_array) || (curr_type.type_name == "double"))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
@@ -500,7 +537,7 @@ void SemanticChecker::visit(CallExpr& e)
     {
       error("Invalid number of parameters", e.first_token());
     }
-    e.args[0].accept(*this);
+    visit(e.args[0]);
     if((curr_type.type_name != "string") && !(curr_type.is_array))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
@@ -513,29 +550,29 @@ void SemanticChecker::visit(CallExpr& e)
     {
       error("Invalid number of parameters", e.first_token());
     }
-    e.args[0].accept(*this);
+    visit(e.args[0]);
     if((curr_type.type_name != "string") || (curr_type.is_array))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
     }
-    e.args[1].accept(*this);
+    visit(e.args[1]);
     if((curr_type.type_name != "string") || (curr_type.is_array))
     {
       error("Invalid parameter type cannot have " + curr_type.type_name, e.first_token());
     }
     curr_type = {false,"string"};
   }
-  else if(fun_defs.contains(fun_name))
+  else if(fun_defs.contains(e.fun_name.symbol()))
   {
-    FunDef f = fun_defs[fun_name];
+    const FunDef& f = *fun_defs.find(e.fun_name.symbol())->second;
     if(e.args.size() != f.params.size())
     {
       error("Invalid number of parameters", e.first_token());
     }
     for(int i = 0; i < e.args.size(); i++)
     {
-      DataType param = f.params[i].data_type;
-      e.args[i].accept(*this);
+      const DataType& param = f.params[i].data_type;
+      visit(e.args[i]);
       if((curr_type.type_name != param.type_name) || (curr_type.is_array != param.is_array))
       {
         if(curr_type.type_name != "void")
@@ -550,69 +587,140 @@ void SemanticChecker::visit(CallExpr& e)
   {
     error("Function used before defined", e.first_token());
   }
-
+  record_type(e.Stmt::id);
 }
 
 
 /**
- * The function checks the type of the first expression and checks if the type of the second expression
- * is the same as the first expression. If the operator exist it checks that the types are correct for each operator
+ * Checks the types of the terms in source order, then the operators in
+ * precedence order (each operand's type is that of its term or of an
+ * earlier operator's result). Parenthesized terms are checked by the
+ * same loop, with the expressions still being checked on a stack (so
+ * deeply nested parentheses take no extra recursion).
  * 
  * @param e The expression we are visiting
  */
 void SemanticChecker::visit(Expr& e)
 {
-  e.first->accept(*this);
-  DataType lhs = curr_type;
-  if(e.op.has_value())
+  size_t frame_base = expr_frames.size();
+  expr_frames.push_back(ExprFrame {&e, 0, expr_types.size(), nullptr});
+  while(expr_frames.size() > frame_base)
   {
-    e.rest->accept(*this);
-    DataType rhs = curr_type;
-    if((e.op.value().lexeme() == "+") || (e.op.value().lexeme() == "-") || (e.op.value().lexeme() == "*") || (e.op.value().lexeme() == "/"))
+    ExprFrame& f = expr_frames.back();
+    Expr& curr = *f.expr;
+    if(f.next_term <= curr.rest.size())
     {
-      if((lhs.type_name != rhs.type_name) || (lhs.is_array != rhs.is_array))
-      {
-        error("Type mismatch must have same type for " + e.op.value().lexeme(), e.op.value());
-      }
-      if((lhs.type_name != "double") && (lhs.type_name != "int") && (rhs.type_name != "double") && (rhs.type_name != "int"))
+      ExprTerm* t = curr.term(f.next_term++);
+      if(t->kind == NodeKind::COMPLEX_TERM) // checked as an expression of its own
       {
-        error("Invalid type cannot use " + lhs.type_name + " with " + e.op.value().lexeme(), e.first_token());
+        Expr* group = &static_cast<ComplexTerm*>(t)->expr;
+        expr_frames.push_back(ExprFrame {group, 0, expr_types.size(), t});
+        continue;
       }
+      visit(static_cast<SimpleTerm&>(*t));
+      if(!curr.rest.empty())
+        expr_types.push_back(curr_type);
+      continue;
+    }
+    check_operators(curr, f.types_base);
+    record_type(curr.id);
+    if(f.group)
+      record_type(f.group->id);
+    expr_frames.pop_back();
+    // the type of a parenthesized term of the enclosing expression
+    if((expr_frames.size() > frame_base) &&
+       !expr_frames.back().expr->rest.empty())
+      expr_types.push_back(curr_type);
+  }
+}
+
+
+/**
+ * Checks the operators of an expression whose term types (if it has
+ * more than one term) are on the type stack from base up, leaving the
+ * expression's type as the current type
+ * 
+ * @param e The expression whose terms have been checked
+ * @param base Where the expression's term types start
+ */
+void SemanticChecker::check_operators(Expr& e, size_t base)
+{
+  if(e.nodes.empty())
+    return;
+  // the types of the nodes (above the terms' types)
+  size_t node_base = expr_types.size();
+  // the first term of each node's first operand (for errors)
+  size_t first_base = expr_first_terms.size();
+  for(const ExprNode& n : e.nodes)
+  {
+    size_t lhs = (n.lhs < 0) ? base + ~n.lhs : node_base + n.lhs;
+    size_t rhs = (n.rhs < 0) ? base + ~n.rhs : node_base + n.rhs;
+    int32_t first_term = (n.lhs < 0) ? ~n.lhs : expr_first_terms[first_base + n.lhs];
+    expr_types.push_back(op_type(e.rest[n.op].op, expr_types[lhs], expr_types[rhs], *e.term(first_term)));
+    expr_first_terms.push_back(first_term);
+  }
+  curr_type = expr_types.back();
+  expr_types.resize(base);
+  expr_first_terms.resize(first_base);
+}
+
+
+/**
+ * The function checks that the types of the operands are the same and are correct for the operator
+ * 
+ * @param op The operator
+ * @param lhs The type of the first operand
+ * @param rhs The type of the second operand
+ * @param lhs_term The first term of the first operand
+ * @return The type of the result
+ */
+DataType SemanticChecker::op_type(TokenRef op, const DataType& lhs, const DataType& rhs, ExprTerm& lhs_term)
+{
+  curr_type = rhs;
+  if((op.lexeme_view(*source) == "+") || (op.lexeme_view(*source) == "-") || (op.lexeme_view(*source) == "*") || (op.lexeme_view(*source) == "/"))
+  {
+    if((lhs.type_name != rhs.type_name) || (lhs.is_array != rhs.is_array))
+    {
+      error("Type mismatch must have same type for " + op.lexeme(*source), op);
     }
-    else if((e.op.value().lexeme() == "==") || (e.op.value().lexeme() == "!="))
+    if((lhs.type_name != "double") && (lhs.type_name != "int") && (rhs.type_name != "double") && (rhs.type_name != "int"))
     {
-      if((lhs.type_name != rhs.type_name) && (lhs.type_name != "void") && (rhs.type_name != "void"))
-      {
-        error("Invalid type cannot use " + lhs.type_name + " with " + e.op.value().lexeme(), e.first_token());
-      }
-      curr_type = DataType {false, "bool"};
+      error("Invalid type cannot use " + lhs.type_name + " with " + op.lexeme(*source), lhs_term.first_token());
     }
-    else if((e.op.value().lexeme() == "<") || (e.op.value().lexeme() == "<=") || (e.op.value().lexeme() == ">") || (e.op.value().lexeme() == ">="))
+  }
+  else if((op.lexeme_view(*source) == "==") || (op.lexeme_view(*source) == "!="))
+  {
+    if((lhs.type_name != rhs.type_name) && (lhs.type_name != "void") && (rhs.type_name != "void"))
     {
-      if((lhs.type_name != rhs.type_name) || (lhs.is_array != rhs.is_array))
-      {
-        error("Type mismatch must have same type for " + e.op.value().lexeme() + " cannot have type " + lhs.type_name + " with " + rhs.type_name, e.op.value());
-      }
-      if((lhs.type_name != "double") && (lhs.type_name != "int") && (lhs.type_name != "char") && (lhs.type_name != "string") && (rhs.type_name != "double") && (rhs.type_name != "int") && (rhs.type_name != "char") && (rhs.type_name != "string"))
-      {
-        error("Invalid type cannot use " + lhs.type_name + " with " + e.op.value().lexeme(), e.first_token());
-      }
-      curr_type.type_name = "bool";
+      error("Invalid type cannot use " + lhs.type_name + " with " + op.lexeme(*source), lhs_term.first_token());
     }
-    else if((e.op.value().lexeme() == "and") || (e.op.value().lexeme() == "or") || (e.op.value().lexeme() == "not"))
+    curr_type = DataType {false, "bool"};
+  }
+  else if((op.lexeme_view(*source) == "<") || (op.lexeme_view(*source) == "<=") || (op.lexeme_view(*source) == ">") || (op.lexeme_view(*source) == ">="))
+  {
+    if((lhs.type_name != rhs.type_name) || (lhs.is_array != rhs.is_array))
     {
-      if((lhs.type_name != rhs.type_name) || (lhs.is_array != rhs.is_array))
-      {
-        error("Type mismatch must have same type for " + e.op.value().lexeme(), e.op.value());
-      }
-      if((lhs.type_name != "bool") && (rhs.type_name != "bool"))
-      {
-        error("Invalid type cannot use " + lhs.type_name + " with " + e.op.value().lexeme(), e.first_token());
-      }
-      curr_type.type_name = "bool";
+      error("Type mismatch must have same type for " + op.lexeme(*source) + " cannot have type " + lhs.type_name + " with " + rhs.type_name, op);
+    }
+    if((lhs.type_name != "double") && (lhs.type_name != "int") && (lhs.type_name != "char") && (lhs.type_name != "string") && (rhs.type_name != "double") && (rhs.type_name != "int") && (rhs.type_name != "char") && (rhs.type_name != "string"))
+    {
+      error("Invalid type cannot use " + lhs.type_name + " with " + op.lexeme(*source), lhs_term.first_token());
     }
+    curr_type.type_name = "bool";
   }
-
+  else if((op.lexeme_view(*source) == "and") || (op.lexeme_view(*source) == "or") || (op.lexeme_view(*source) == "not"))
+  {
+    if((lhs.type_name != rhs.type_name) || (lhs.is_array != rhs.is_array))
+    {
+      error("Type mismatch must have same type for " + op.lexeme(*source), op);
+    }
+    if((lhs.type_name != "bool") && (rhs.type_name != "bool"))
+    {
+      error("Invalid type cannot use " + lhs.type_name + " with " + op.lexeme(*source), lhs_term.first_token());
+    }
+    curr_type.type_name = "bool";
+  }
+  return curr_type;
 }
 
 
@@ -623,7 +731,8 @@ void SemanticChecker::visit(Expr& e)
  */
 void SemanticChecker::visit(SimpleTerm& t)
 {
-  t.rvalue->accept(*this);
+  visit(*t.rvalue);
+  record_type(t.id);
 } 
 
 
@@ -634,7 +743,8 @@ void SemanticChecker::visit(SimpleTerm& t)
  */
 void SemanticChecker::visit(ComplexTerm& t)
 {
-  t.expr.accept(*this);
+  visit(t.expr);
+  record_type(t.id);
 }
 
 
@@ -646,22 +756,22 @@ void SemanticChecker::visit(ComplexTerm& t)
  */
 void SemanticChecker::visit(NewRValue& v)
 {
-  if((v.type.lexeme() != "int") && (v.type.lexeme() != "double") && (v.type.lexeme() != "char") && (v.type.lexeme() != "string") && (v.type.lexeme() != "bool"))
+  if((v.type.lexeme_view(*source) != "int") && (v.type.lexeme_view(*source) != "double") && (v.type.lexeme_view(*source) != "char") && (v.type.lexeme_view(*source) != "string") && (v.type.lexeme_view(*source) != "bool"))
     {
-      if(!(symbol_table.name_exists(v.type.lexeme())) && !(struct_defs.contains(v.type.lexeme())))
+      if(!(symbol_table.name_exists(v.type.lexeme(*source))) && !(struct_defs.contains(v.type.symbol())))
         {
-          error("invalid New Rvalue Type type '" + v.type.lexeme() + "'", v.type);
+          error("invalid New Rvalue Type type '" + v.type.lexeme(*source) + "'", v.type);
         }
     }
     if(v.array_expr.has_value())
     {
-      curr_type = {true, v.type.lexeme()};
+      curr_type = {true, v.type.lexeme(*source)};
     }
     else
     {
-      curr_type = {false, v.type.lexeme()};
+      curr_type = {false, v.type.lexeme(*source)};
     }
-    
+    record_type(v.id);
 }
 
 
@@ -672,17 +782,17 @@ void SemanticChecker::visit(NewRValue& v)
  */
 void SemanticChecker::visit(VarRValue& v)
 {
-  string var_name = v.path[0].var_name.lexeme();
+  SymbolId var_name = v.path[0].var_name.symbol();
   if(symbol_table.name_exists(var_name))
   {
     DataType d = symbol_table.get(var_name).value();
     curr_type = DataType(symbol_table.get(var_name)->is_array, symbol_table.get(var_name).value().type_name);
-    if(struct_defs.contains(curr_type.type_name))
+    if(struct_defs.contains(type_symbol(curr_type.type_name)))
     {
       for(int i = 1; i < v.path.size(); i++)
       {
-        string var_name2 = v.path[i].var_name.lexeme();
-        VarDef field = get_field(struct_defs[curr_type.type_name], var_name2).value();
+        SymbolId var_name2 = v.path[i].var_name.symbol();
+        VarDef field = get_field(struct_defs[type_symbol(curr_type.type_name)], var_name2).value();
         curr_type = {field.data_type.is_array, field.data_type.type_name};
       }
     }
@@ -691,4 +801,5 @@ void SemanticChecker::visit(VarRValue& v)
   {
     error("Use before definition", v.first_token());
   }
+  record_type(v.id);
 }
@@ -8,12 +8,16 @@
 #ifndef SEMANTIC_CHECKER_H
 #define SEMANTIC_CHECKER_H
 
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 #include "ast.h"
+#include "interner.h"
+#include "node_table.h"
 #include "symbol_table.h"
 
 
-class SemanticChecker : public Visitor
+class SemanticChecker final : public Visitor
 {
 public:
 
@@ -36,26 +40,92 @@ public:
   void visit(NewRValue& v);
   void visit(VarRValue& v);    
 
+  // the type found for an expression, term, or rvalue (of the program
+  // last checked, an empty type name for other nodes)
+  const DataType& type_of(NodeId id) const
+  {return found_types[type_indexes[id]];}
+  const DataType& type_of(const ASTNode& n) const {return type_of(n.id);}
+
 private:
 
+  // visit the statement, term, or rvalue as its own node type (by
+  // switching on its kind rather than through accept)
+  void visit(Stmt& s) {dispatch(s, [this](auto& n) {visit(n);});}
+  void visit(ExprTerm& t) {dispatch(t, [this](auto& n) {visit(n);});}
+  void visit(RValue& v) {dispatch(v, [this](auto& n) {visit(n);});}
+
   // symbol table
   SymbolTable symbol_table;
 
+  // source of the program being checked (which its tokens refer to)
+  const SourceBuffer* source = nullptr;
+
   // current inferred type
   DataType curr_type;
 
-  // mapping from struct names to corresponding ast objects
-  std::unordered_map<std::string, StructDef> struct_defs;
+  // the index in found_types of each node's type, the distinct types
+  // found (the first being the empty type), and the index of each type
+  // by name (0 if not yet found)
+  NodeTable<std::uint32_t> type_indexes;
+  std::vector<DataType> found_types;
+  struct TypeIndex
+  {
+    std::uint32_t plain = 0;
+    std::uint32_t array = 0;
+  };
+  std::unordered_map<std::string, TypeIndex> type_index_by_name;
+  // the index of the type last recorded
+  std::uint32_t last_type_index = 0;
+
+  // types of the terms and operators of the expressions being checked,
+  // and the first term of each operator (shared by nested expressions,
+  // each above the last)
+  std::vector<DataType> expr_types;
+  std::vector<std::int32_t> expr_first_terms;
+
+  // expressions being checked (innermost last), each with its next term
+  // to check and where its term types start
+  struct ExprFrame
+  {
+    Expr* expr;
+    std::size_t next_term;
+    std::size_t types_base;
+    // the parenthesized term the expression is in (if any)
+    ExprTerm* group;
+  };
+  std::vector<ExprFrame> expr_frames;
+
+  // mapping from (interned) struct names to corresponding ast objects
+  // (in the program being checked)
+  std::unordered_map<SymbolId, const StructDef*> struct_defs;
+
+  // mapping from (interned) function names to corresponding ast objects
+  // (in the program being checked)
+  std::unordered_map<SymbolId, const FunDef*> fun_defs;
+
+  // helper function to get field in struct def (none if there is no
+  // struct def)
+  std::optional<VarDef> get_field(const StructDef* struct_def,
+                                  SymbolId field_name);
+
+  // helper function to get the result type of a binary operator (its
+  // first operand starts with lhs_term)
+  DataType op_type(TokenRef op, const DataType& lhs, const DataType& rhs,
+                   ExprTerm& lhs_term);
+
+  // helper function to check the operators of an expression whose
+  // terms have been checked (their types starting at base)
+  void check_operators(Expr& e, std::size_t base);
 
-  // mapping from function names to corresponding ast objects
-  std::unordered_map<std::string, FunDef> fun_defs;
+  // helper function to get the interned id of a type name (NO_SYMBOL
+  // for names that were never interned, e.g., base types)
+  SymbolId type_symbol(const std::string& type_name) const;
 
-  // helper function to get field in struct def
-  std::optional<VarDef> get_field(const StructDef& struct_def,
-                                  const std::string& field_name);
+  // helper function to record the current type as the node's type
+  void record_type(NodeId id);
 
   // error helper functions
-  void error(const std::string& msg, const Token& token);
+  void error(const std::string& msg, TokenRef token);
   void error(const std::string& msg);
 
 };
@@ -8,65 +8,114 @@
 #ifndef SIMPLE_PARSER_H
 #define SIMPLE_PARSER_H
 
-#include "mypl_exception.h"
-#include "lexer.h"
+#include <type_traits>
+#include "parser.h"
+#include "token_cursor.h"
 
 
-class SimpleParser
+// Builds nothing (so checking syntax only advances through the tokens):
+// every part of the grammar is the same empty node, and every action
+// returns it.
+class NullBuilder
 {
 public:
 
-  // crate a new recursive descent parer
-  SimpleParser(const Lexer& lexer);
+  struct Node {};
+
+  // node types built for each part of the grammar
+  using Program = Node;
+  using StructDef = Node;
+  using FunDef = Node;
+  using VarDef = Node;
+  using DataType = Node;
+  using StmtList = Node;
+  using VarDeclStmt = Node;
+  using AssignStmt = Node;
+  using IfStmt = Node;
+  using BasicIf = Node;
+  using WhileStmt = Node;
+  using ForStmt = Node;
+  using ReturnStmt = Node;
+  using DeleteStmt = Node;
+  using CallExpr = Node;
+  using Expr = Node;
+  using RValueSlot = Node;
+  using NewRValue = Node;
+  using SimpleRValue = Node;
+  using Path = Node;
+
+  Program program(const TokenCursor&) {return Node {};}
+  void end_program(Node&) {}
+
+  // definitions
+  Node& struct_def(Node&) {return node;}
+  Node& fun_def(Node&) {return node;}
+  Node& field(Node&) {return node;}
+  Node& param(Node&) {return node;}
+  Node& return_type(Node&) {return node;}
+  Node& data_type(Node&) {return node;}
+  void array_type(Node&) {}
+
+  // names and values taken from the current token
+  void name(Node&, const TokenCursor&) {}
+  void type_name(Node&, const TokenCursor&) {}
+  void value(Node&, const TokenCursor&) {}
+  void type(Node&, const TokenCursor&) {}
+  void path_name(Node&, const TokenCursor&) {}
+  Node& index(Node&) {return node;}
+
+  // statements
+  Node& var_decl_stmt(Node&) {return node;}
+  Node& assign_stmt(Node&) {return node;}
+  Node& call_stmt(Node&) {return node;}
+  Node& if_stmt(Node&) {return node;}
+  Node& while_stmt(Node&) {return node;}
+  Node& for_stmt(Node&) {return node;}
+  Node& return_stmt(Node&) {return node;}
+  Node& delete_stmt(Node&) {return node;}
+
+  // parts of statements
+  Node& stmts(Node&) {return node;}
+  Node& else_stmts(Node&) {return node;}
+  Node& if_part(Node&) {return node;}
+  Node& else_if(Node&) {return node;}
+  Node& condition(Node&) {return node;}
+  Node& for_var_decl(Node&) {return node;}
+  Node& for_assign(Node&) {return node;}
+  Node& var_def(Node&) {return node;}
+  Node& lvalue(Node&) {return node;}
+  Node& expr(Node&) {return node;}
+  Node& arg(Node&) {return node;}
+
+  // expressions
+  Node begin_expr(Node&) {return Node {};}
+  void negation(Node&) {}
+  Node& open_group(Node&) {return node;}
+  Node& close_group(Node&) {return node;}
+  Node& simple_term(Node&) {return node;}
+  void op(Node&, const TokenCursor&) {}
+  void end_expr(Node&, Node) {}
+
+  // rvalues
+  Node& simple_rvalue(Node&) {return node;}
+  Node& new_rvalue(Node&) {return node;}
+  Node& call_rvalue(Node&) {return node;}
+  Node& var_rvalue(Node&) {return node;}
+  Node& array_size(Node&) {return node;}
 
-  // run the parser
-  void parse();
-  
 private:
-  
-  Lexer lexer;
-  Token curr_token;
-  
-  // helper functions
-  void advance();
-  void eat(TokenType t, const std::string& msg);
-  bool match(TokenType t);
-  bool match(std::initializer_list<TokenType> types);
-  void error(const std::string& msg);
-  bool bin_op();
-
-  // recursive descent functions
-  void struct_def();
-  void fun_def();
-  void fields();
-  void data_type();
-  void base_type();
-  void stmt();
-  void vdecl_stmt();
-  void assign_stmt();
-  void delete_stmt();
-  void lvalue();
-  void if_stmt();
-  void if_stmt_tail();
-  void while_stmt();
-  void for_stmt();
-  void call_expr();
-  void ret_stmt();
-  void expr();
-  void rvalue();
-  void new_rvalue();
-  void base_rvalue();
-  void var_rvalue();
-
-  void params();
-  // TODO:
-  //   -- Add remaining recursive descent function declarations here.
-  //   -- Note that you need to follow the general flow of the MyPL
-  //      syntax specification, but there may be a few places you will
-  //      want to simplify and/or diverge.
-  //   -- Be sure to remove this comment block when you are finished.
-  
+
+  // the node every part refers to
+  Node node;
+
 };
 
+static_assert(std::is_empty_v<NullBuilder::Node>,
+              "the syntax checker builds nothing");
+
+
+// checks the syntax of the program (without building anything)
+using SimpleParser = Parser<NullBuilder>;
+
 
 #endif
@@ -0,0 +1,194 @@
+//----------------------------------------------------------------------
+// FILE: source_buffer.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Memory-mapped and block-buffered source text implementation
+//----------------------------------------------------------------------
+
+#include <algorithm>
+#include <fstream>
+#include "mypl_exception.h"
+#include "scan.h"
+#include "source_buffer.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MYPL_HAS_MMAP 1
+#endif
+
+using namespace std;
+
+// size of each read when slurping a stream
+const size_t BLOCK_SIZE = 1 << 16;
+
+
+// throws if the input is larger than the maximum size
+static void check_size(size_t size, size_t max_size)
+{
+  if (size > max_size)
+    throw MyPLException::LexerError("input is larger than " +
+                                    to_string(max_size) + " bytes");
+}
+
+
+shared_ptr<SourceBuffer> SourceBuffer::from_file(const string& path,
+                                                  size_t max_size)
+{
+#ifdef MYPL_HAS_MMAP
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+    if (static_cast<uintmax_t>(info.st_size) > max_size) {
+      close(fd);
+      check_size(info.st_size, max_size);
+    }
+    void* addr = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr != MAP_FAILED) {
+      close(fd);
+      madvise(addr, info.st_size, MADV_SEQUENTIAL);
+      shared_ptr<SourceBuffer> buffer(new SourceBuffer());
+      buffer->data = static_cast<const char*>(addr);
+      buffer->length = info.st_size;
+      buffer->mapped = true;
+      return buffer;
+    }
+  }
+  close(fd);
+#endif
+  // empty, non-regular, or unmappable files are read in blocks
+  ifstream input(path, ios::binary);
+  if (input.fail())
+    return nullptr;
+  return from_stream(input, max_size);
+}
+
+
+shared_ptr<SourceBuffer> SourceBuffer::from_stream(istream& input,
+                                                    size_t max_size)
+{
+  string text;
+  streambuf* buf = input.rdbuf();
+  size_t used = 0;
+  while (buf) {
+    text.resize(used + BLOCK_SIZE);
+    streamsize n = buf->sgetn(text.data() + used, BLOCK_SIZE);
+    if (n <= 0)
+      break;
+    used += n;
+    check_size(used, max_size); // before reading on
+  }
+  text.resize(used);
+  input.setstate(ios::eofbit);
+  return from_string(std::move(text));
+}
+
+
+shared_ptr<SourceBuffer> SourceBuffer::from_string(string text,
+                                                   int first_line,
+                                                   int first_column)
+{
+  shared_ptr<SourceBuffer> buffer(new SourceBuffer());
+  buffer->owned_text = std::move(text);
+  buffer->data = buffer->owned_text.data();
+  buffer->length = buffer->owned_text.size();
+  buffer->first_line = first_line;
+  buffer->first_column = first_column;
+  return buffer;
+}
+
+
+shared_ptr<SourceBuffer>
+SourceBuffer::slice(shared_ptr<const SourceBuffer> whole, size_t offset,
+                    size_t size)
+{
+  shared_ptr<SourceBuffer> buffer(new SourceBuffer());
+  buffer->data = whole->data + offset;
+  buffer->length = size;
+  buffer->owner = std::move(whole);
+  return buffer;
+}
+
+
+SourceBuffer::~SourceBuffer()
+{
+#ifdef MYPL_HAS_MMAP
+  if (mapped)
+    munmap(const_cast<char*>(data), length);
+#endif
+}
+
+
+const char* SourceBuffer::begin() const
+{
+  return data;
+}
+
+
+const char* SourceBuffer::end() const
+{
+  return data + length;
+}
+
+
+size_t SourceBuffer::size() const
+{
+  return length;
+}
+
+
+string_view SourceBuffer::text() const
+{
+  return string_view(data, length);
+}
+
+
+SourcePosition SourceBuffer::position(size_t offset) const
+{
+  const vector<uint32_t>& starts = line_index();
+  // the line is the last one starting at or before offset
+  size_t line = upper_bound(starts.begin(), starts.end(), offset) -
+    starts.begin() - 1;
+  return position_on_line(offset, line);
+}
+
+
+SourcePosition SourceBuffer::position(size_t offset, size_t& line) const
+{
+  const vector<uint32_t>& starts = line_index();
+  if ((line >= starts.size()) || (starts[line] > offset))
+    line = upper_bound(starts.begin(), starts.end(), offset) -
+      starts.begin() - 1;
+  else
+    while ((line + 1 < starts.size()) && (starts[line + 1] <= offset))
+      ++line;
+  return position_on_line(offset, line);
+}
+
+
+SourcePosition SourceBuffer::position_on_line(size_t offset, size_t line) const
+{
+  if (line == 0)
+    return SourcePosition {first_line, first_column + static_cast<int>(offset)};
+  return SourcePosition {first_line + static_cast<int>(line),
+                         static_cast<int>(offset - line_starts[line]) + 1};
+}
+
+
+const vector<uint32_t>& SourceBuffer::line_index() const
+{
+  call_once(line_index_built, [this] {
+    line_starts.push_back(0);
+    const char* p = data;
+    const char* last = data + length;
+    while ((p = scan_newline(p, last)) != last) {
+      ++p;
+      line_starts.push_back(p - data);
+    }
+  });
+  return line_starts;
+}
@@ -0,0 +1,117 @@
+//----------------------------------------------------------------------
+// FILE: source_buffer.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Contiguous, read-only MyPL source text for the lexer
+//----------------------------------------------------------------------
+
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// largest source the lexer takes (token offsets and line starts are 32
+// bits, and EOS is at the offset just past the source)
+const std::size_t MAX_SOURCE_SIZE = UINT32_MAX;
+
+
+// a 1-based line and column in a source
+struct SourcePosition
+{
+  int line;
+  int column;
+};
+
+
+class SourceBuffer
+{
+public:
+
+  // memory-map the given file (falls back to a block read if the file
+  // cannot be mapped), returns nullptr if the file cannot be opened and
+  // throws if it is larger than max_size bytes
+  static std::shared_ptr<SourceBuffer>
+  from_file(const std::string& path, std::size_t max_size = MAX_SOURCE_SIZE);
+
+  // read the entire stream into the buffer in large blocks, throws if it
+  // is larger than max_size bytes
+  static std::shared_ptr<SourceBuffer>
+  from_stream(std::istream& input, std::size_t max_size = MAX_SOURCE_SIZE);
+
+  // take ownership of the given text, whose first character is at the
+  // given line and column (e.g., when the text is a single lexeme)
+  static std::shared_ptr<SourceBuffer> from_string(std::string text,
+                                                   int first_line = 1,
+                                                   int first_column = 1);
+
+  // a view of the bytes [offset, offset + size) of another buffer, which
+  // it keeps alive (e.g., source text stored inside a mapped file)
+  static std::shared_ptr<SourceBuffer>
+  slice(std::shared_ptr<const SourceBuffer> whole, std::size_t offset,
+        std::size_t size);
+
+  SourceBuffer(const SourceBuffer&) = delete;
+  SourceBuffer& operator=(const SourceBuffer&) = delete;
+  ~SourceBuffer();
+
+  // pointer to the first byte of the source
+  const char* begin() const;
+  // pointer one past the last byte of the source
+  const char* end() const;
+  // number of bytes in the source
+  std::size_t size() const;
+  // the whole source as a view
+  std::string_view text() const;
+
+  // line and column of the byte at the given offset (computed from an
+  // index of line start offsets that is built on first use)
+  SourcePosition position(std::size_t offset) const;
+
+  // same as above, but the line search starts at (and updates) the
+  // given 0-based line index, so visiting increasing offsets in order
+  // takes linear rather than n log n time
+  SourcePosition position(std::size_t offset, std::size_t& line) const;
+
+private:
+
+  SourceBuffer() = default;
+
+  // the source bytes (either mapped or pointing into owned_text)
+  const char* data = nullptr;
+  std::size_t length = 0;
+
+  // true if data was obtained from mmap and must be unmapped
+  bool mapped = false;
+
+  // backing storage when the source is not memory mapped
+  std::string owned_text;
+
+  // buffer that a slice's bytes belong to
+  std::shared_ptr<const SourceBuffer> owner;
+
+  // position of the first byte
+  int first_line = 1;
+  int first_column = 1;
+
+  // offset of the start of each line (built once, on first use, since
+  // positions are only needed for diagnostics and printing)
+  mutable std::once_flag line_index_built;
+  mutable std::vector<std::uint32_t> line_starts;
+
+  // returns the line start index, building it if needed
+  const std::vector<std::uint32_t>& line_index() const;
+
+  // position of the byte at offset, which is on the given 0-based line
+  SourcePosition position_on_line(std::size_t offset, std::size_t line) const;
+
+};
+
+#endif
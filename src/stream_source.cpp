@@ -0,0 +1,55 @@
+//----------------------------------------------------------------------
+// FILE: stream_source.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Bounded-memory stream source implementation
+//----------------------------------------------------------------------
+
+#include <algorithm>
+#include <string_view>
+#include "stream_source.h"
+
+using namespace std;
+
+
+StreamSource::StreamSource(istream& input, size_t chunk_size)
+  : input {input}, chunk(max<size_t>(chunk_size, 1))
+{}
+
+
+shared_ptr<const SourceBuffer> StreamSource::next_window()
+{
+  // read until there is at least one whole line (pending never holds a
+  // newline here, and a line longer than a chunk grows it until its
+  // newline arrives)
+  size_t newline = string::npos;
+  while (!at_end && (newline == string::npos)) {
+    streambuf* buf = input.rdbuf();
+    streamsize n = buf ? buf->sgetn(chunk.data(), chunk.size()) : 0;
+    if (n <= 0) {
+      at_end = true;
+      input.setstate(ios::eofbit);
+    }
+    else {
+      size_t old_size = pending.size();
+      pending.append(chunk.data(), n);
+      newline = string_view(pending).substr(old_size).rfind('\n');
+      if (newline != string::npos)
+        newline += old_size;
+    }
+  }
+  if (pending.empty())
+    return nullptr;
+
+  // hand out everything through the last newline (or the rest at the end)
+  string text;
+  if (at_end)
+    text.swap(pending);
+  else {
+    text = pending.substr(0, newline + 1);
+    pending.erase(0, newline + 1);
+  }
+  int first_line = line;
+  line += count(text.begin(), text.end(), '\n');
+  return SourceBuffer::from_string(std::move(text), first_line);
+}
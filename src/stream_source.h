@@ -0,0 +1,58 @@
+//----------------------------------------------------------------------
+// FILE: stream_source.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Bounded-memory source text read from a stream (e.g., a pipe)
+//----------------------------------------------------------------------
+
+#ifndef STREAM_SOURCE_H
+#define STREAM_SOURCE_H
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "source_buffer.h"
+
+
+// bytes read from the stream at a time
+const std::size_t STREAM_CHUNK_SIZE = std::size_t(1) << 16;
+
+
+// Reads a stream a fixed-size chunk at a time and hands the text out as
+// a sequence of windows, each a SourceBuffer of whole lines (anchored
+// at its first line). MyPL tokens never span lines, so no token
+// straddles two windows, and only the windows still referenced (by the
+// lexer or by tokens that are kept) stay in memory. The bytes after the
+// last newline read so far are carried over to the next window.
+class StreamSource
+{
+public:
+
+  // read the given stream chunk_size bytes at a time
+  StreamSource(std::istream& input, std::size_t chunk_size = STREAM_CHUNK_SIZE);
+
+  // returns the next window of the stream (or nullptr at its end)
+  std::shared_ptr<const SourceBuffer> next_window();
+
+private:
+
+  std::istream& input;
+
+  // fixed-size buffer each read goes into
+  std::vector<char> chunk;
+
+  // bytes read but not yet handed out (a partial line)
+  std::string pending;
+
+  // line the next window starts on
+  int line = 1;
+
+  // true once the stream is exhausted
+  bool at_end = false;
+
+};
+
+
+#endif
@@ -13,7 +13,7 @@ using namespace std;
 
 void SymbolTable::push_environment()
 {
-  environments.push_back(unordered_map<string,DataType>());
+  environments.push_back(unordered_map<SymbolId,DataType>());
 }
 
 
@@ -30,12 +30,18 @@ bool SymbolTable::empty() const
 }
 
 
-void SymbolTable::add(const string& name, const DataType& info)
+void SymbolTable::add(SymbolId name, const DataType& info)
 {
   if (!empty())
     environments.back()[name] = info;
 }
 
+
+void SymbolTable::add(const string& name, const DataType& info)
+{
+  add(Interner::global().intern(name), info);
+}
+
 /*
 void SymbolTable::remove(const string& name)
 {
@@ -45,7 +51,7 @@ void SymbolTable::remove(const string& name)
 }
 */
 
-bool SymbolTable::name_exists(const string& name) const
+bool SymbolTable::name_exists(SymbolId name) const
 {
   for (int i = environments.size() - 1; i >= 0; --i)
     if (environments[i].contains(name))
@@ -54,29 +60,51 @@ bool SymbolTable::name_exists(const string& name) const
 }
 
 
-bool SymbolTable::name_exists_in_curr_env(const string& name) const
+bool SymbolTable::name_exists(const string& name) const
+{
+  // a name that was never interned cannot be in any environment
+  return name_exists(Interner::global().find(name));
+}
+
+
+bool SymbolTable::name_exists_in_curr_env(SymbolId name) const
 {
   return !empty() and environments.back().contains(name);
 }
 
 
-optional<DataType> SymbolTable::get(const string& name) const
+bool SymbolTable::name_exists_in_curr_env(const string& name) const
 {
-  for (int i = environments.size() - 1; i >= 0; --i) 
-    if (environments[i].contains(name))
-      return environments[i].at(name);
+  return name_exists_in_curr_env(Interner::global().find(name));
+}
+
+
+optional<DataType> SymbolTable::get(SymbolId name) const
+{
+  for (int i = environments.size() - 1; i >= 0; --i) {
+    auto it = environments[i].find(name);
+    if (it != environments[i].end())
+      return it->second;
+  }
   // couldn't find name, so return null option value
   return nullopt;
 }
 
 
+optional<DataType> SymbolTable::get(const string& name) const
+{
+  return get(Interner::global().find(name));
+}
+
+
 string to_string(const SymbolTable& symbol_table)
 {
   string str = "";
   for (auto env : symbol_table.environments) {
     str += "environment: [";
     for(const auto& [var, type] : env) {
-      str += "\n  " + var + " -> " + type.type_name;
+      str += "\n  " + string(Interner::global().name(var)) + " -> " +
+        type.type_name;
       if (type.is_array)
         str += " (is_array = true)";
       else
@@ -11,6 +11,7 @@
 #include <vector>
 #include <unordered_map>
 #include "ast.h"
+#include "interner.h"
 
 
 class SymbolTable
@@ -25,14 +26,18 @@ public:
   // returns true if the symbol table has no environments
   bool empty() const;
   // add the name, with given type info, to the current environment
+  void add(SymbolId name, const DataType& info);
   void add(const std::string& name, const DataType& info);
   // true if the name exists in any environment
+  bool name_exists(SymbolId name) const;
   bool name_exists(const std::string& name) const;
   // true if the name exists in the last pushed environment
+  bool name_exists_in_curr_env(SymbolId name) const;
   bool name_exists_in_curr_env(const std::string& name) const;
   // return the type info for the given name (if the name exists),
   // searching from most recent to least recent environment (returning
   // first such match)
+  std::optional<DataType> get(SymbolId name) const;
   std::optional<DataType> get(const std::string& name) const;
 
   // pretty print the table for debugging
@@ -40,8 +45,8 @@ public:
   
 private:
 
-  // an environment is a mapping from names to type info
-  std::vector<std::unordered_map<std::string,DataType>> environments;
+  // an environment is a mapping from (interned) names to type info
+  std::vector<std::unordered_map<SymbolId,DataType>> environments;
 
 };
 
@@ -5,19 +5,58 @@
 // DESC: Token implementation
 //----------------------------------------------------------------------
 
-#include <unordered_map>
+#include <charconv>
+#include "mypl_exception.h"
 #include "token.h"
 
 
 Token::Token()
-  : token_type {TokenType::EOS}, token_lexeme {""}, token_line {0},
-    token_column {0}
+  : token_type {TokenType::EOS}, token_copied {false}, token_offset {0},
+    token_length {0}, token_value {NO_SYMBOL}
 {}
 
 Token::Token(TokenType type, const std::string& lexeme, int line, int column)
-  : token_type {type}, token_lexeme {lexeme}, token_line {line},
-    token_column {column}
-{}
+  : token_type {type}, token_copied {true}, token_offset {0},
+    token_length {static_cast<std::uint32_t>(lexeme.size())},
+    token_value {NO_SYMBOL},
+    token_source {SourceBuffer::from_string(lexeme, line, column)}
+{
+  if (type == TokenType::ID)
+    token_value.symbol = Interner::global().intern(lexeme);
+  else
+    token_value = literal_value(type, lexeme);
+}
+
+TokenValue literal_value(TokenType type, std::string_view lexeme)
+{
+  const char* end = lexeme.data() + lexeme.size();
+  TokenValue value {NO_SYMBOL};
+  if (type == TokenType::INT_VAL) {
+    value.int_value = 0;
+    std::from_chars(lexeme.data(), end, value.int_value);
+  }
+  else if (type == TokenType::DOUBLE_VAL) {
+    value.double_value = 0;
+    std::from_chars(lexeme.data(), end, value.double_value);
+  }
+  return value;
+}
+
+Token Token::from_source(TokenType type,
+                         std::shared_ptr<const SourceBuffer> source,
+                         std::size_t offset, std::size_t length,
+                         TokenValue value)
+{
+  Token token;
+  token.token_type = type;
+  token.token_offset = offset;
+  token.token_length = length;
+  token.token_source = std::move(source);
+  if ((type == TokenType::ID) && (value.symbol == NO_SYMBOL))
+    value.symbol = Interner::global().intern(token.lexeme_view());
+  token.token_value = value;
+  return token;
+}
 
 TokenType Token::type() const
 {
@@ -26,56 +65,126 @@ TokenType Token::type() const
 
 std::string Token::lexeme() const
 {
-  return token_lexeme;
+  return std::string(lexeme_view());
+}
+
+std::string_view Token::lexeme_view() const
+{
+  if (!token_source)
+    return "";
+  if ((token_type == TokenType::EOS) && !token_copied)
+    return "end-of-stream";
+  return std::string_view(token_source->begin() + token_offset, token_length);
+}
+
+SymbolId Token::symbol() const
+{
+  if (token_type != TokenType::ID)
+    return NO_SYMBOL;
+  return token_value.symbol;
+}
+
+std::int64_t Token::int_value() const
+{
+  if (token_type != TokenType::INT_VAL)
+    return 0;
+  return token_value.int_value;
+}
+
+double Token::double_value() const
+{
+  if (token_type != TokenType::DOUBLE_VAL)
+    return 0;
+  return token_value.double_value;
+}
+
+TokenValue Token::value() const
+{
+  return token_value;
+}
+
+std::size_t Token::offset() const
+{
+  return token_offset;
 }
 
 int Token::line() const
 {
-  return token_line;
+  return position().line;
 }
 
 int Token::column() const
 {
-  return token_column;
+  return position().column;
+}
+
+SourcePosition Token::position() const
+{
+  if (!token_source)
+    return SourcePosition {0, 0};
+  if (token_copied)
+    return token_source->position(0);
+  return token_source->position(token_start(token_type, token_offset));
 }
 
 std::string to_string(const Token& token)
 {
-  std::unordered_map<TokenType,std::string> ts = {
-    // end-of-stream
-    {TokenType::EOS, "EOS"}, {TokenType::ID, "ID"},
-    // punctuation
-    {TokenType::DOT, "DOT"}, {TokenType::COMMA, "COMMA"},
-    {TokenType::LPAREN, "LPAREN"}, {TokenType::RPAREN, "RPAREN"},
-    {TokenType::LBRACKET, "LBRACKET"}, {TokenType::RBRACKET, "RBRACKET"},
-    {TokenType::SEMICOLON, "SEMICOLON"}, {TokenType::RBRACE, "RBRACE"},
-    {TokenType::LBRACE, "LBRACE"},
-    // operators
-    {TokenType::PLUS, "PLUS"}, {TokenType::MINUS, "MINUS"},
-    {TokenType::TIMES, "TIMES"}, {TokenType::DIVIDE, "DIVIDE"},
-    {TokenType::ASSIGN, "ASSIGN"}, 
-    // comparators
-    {TokenType::LESS, "LESS"}, {TokenType::GREATER, "GREATER"},    
-    {TokenType::LESS_EQ, "LESS_EQ"}, {TokenType::GREATER_EQ, "GREATER_EQ"},
-    {TokenType::EQUAL, "EQUAL"}, {TokenType::NOT_EQUAL, "NOT_EQUAL"},    
-    // values
-    {TokenType::INT_VAL, "INT_VAL"}, {TokenType::DOUBLE_VAL, "DOUBLE_VAL"},        
-    {TokenType::CHAR_VAL, "CHAR_VAL"}, {TokenType::STRING_VAL, "STRING_VAL"},        
-    {TokenType::BOOL_VAL, "BOOL_VAL"}, {TokenType::NULL_VAL, "NULL_VAL"},
-    // primitive types
-    {TokenType::INT_TYPE, "INT_TYPE"}, {TokenType::DOUBLE_TYPE, "DOUBLE_TYPE"},
-    {TokenType::BOOL_TYPE, "BOOL_TYPE"}, {TokenType::STRING_TYPE, "STRING_TYPE"},
-    {TokenType::CHAR_TYPE, "CHAR_TYPE"}, {TokenType::VOID_TYPE, "VOID_TYPE"},
-    // reserved words
-    {TokenType::STRUCT, "STRUCT"}, {TokenType::ARRAY, "ARRAY"},
-    {TokenType::FOR, "FOR"}, {TokenType::WHILE, "WHILE"},
-    {TokenType::IF, "IF"}, {TokenType::ELSEIF, "ELSEIF"},
-    {TokenType::ELSE, "ELSE"}, {TokenType::AND, "AND"},
-    {TokenType::OR, "OR"}, {TokenType::NOT, "NOT"},
-    {TokenType::NEW, "NEW"}, {TokenType::RETURN, "RETURN"},
-    {TokenType::DELETE, "DELETE"}
-  };
-  return std::to_string(token.line()) + ", "
-    + std::to_string(token.column()) + ": "
-    + ts[token.type()] + " '" +  token.lexeme() + "'";
+  SourcePosition pos = token.position();
+  return std::to_string(pos.line) + ", "
+    + std::to_string(pos.column) + ": "
+    + std::string(token_type_name(token.type())) + " '"
+    + token.lexeme() + "'";
+}
+
+
+TokenRef::TokenRef(const Token& token, const SourceBuffer& source)
+{
+  if (token.type() == TokenType::EOS) {
+    ref_offset = source.size();
+    ref_info = static_cast<std::uint8_t>(TokenType::EOS);
+    return;
+  }
+  std::string_view lexeme = token.lexeme_view();
+  if ((lexeme.data() < source.begin()) || (lexeme.data() > source.end()) ||
+      (lexeme.size() > static_cast<std::size_t>(source.end() - lexeme.data())))
+    throw MyPLException("token '" + std::string(lexeme) + "' is not in the "
+                        "program's source");
+  std::uint32_t extra = lexeme.size();
+  if (token.type() == TokenType::ID)
+    extra = token.symbol();
+  if (extra > TOKEN_REF_MAX)
+    throw MyPLException("token '" + std::string(lexeme.substr(0, 20)) +
+                        "' is too long (or the program has too many names)");
+  ref_offset = lexeme.data() - source.begin();
+  ref_info = (extra << 8) | static_cast<std::uint8_t>(token.type());
+}
+
+TokenRef::TokenRef(TokenType type, std::uint32_t offset,
+                   std::uint32_t symbol_or_length)
+  : ref_offset {offset},
+    ref_info {(symbol_or_length << 8) | static_cast<std::uint8_t>(type)}
+{}
+
+SymbolId TokenRef::symbol() const
+{
+  if (type() != TokenType::ID)
+    return NO_SYMBOL;
+  return ref_info >> 8;
+}
+
+std::string_view TokenRef::lexeme_view(const SourceBuffer& source) const
+{
+  if (type() == TokenType::ID)
+    return Interner::global().name(symbol());
+  return std::string_view(source.begin() + ref_offset, ref_info >> 8);
+}
+
+std::string TokenRef::lexeme(const SourceBuffer& source) const
+{
+  return std::string(lexeme_view(source));
+}
+
+SourcePosition TokenRef::position(const SourceBuffer& source) const
+{
+  return source.position(token_start(type(), ref_offset));
 }
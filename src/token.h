@@ -8,10 +8,17 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
+#include "interner.h"
+#include "source_buffer.h"
 
 
-enum class TokenType {
+enum class TokenType : std::uint8_t {
   // end-of-stream and identifiers
   EOS, ID, 
   // punctuation
@@ -29,22 +36,109 @@ enum class TokenType {
 };
 
 
+// printable name of each token type (indexed by the type's value)
+constexpr std::string_view TOKEN_TYPE_NAMES[] = {
+  // end-of-stream and identifiers
+  "EOS", "ID",
+  // punctuation
+  "DOT", "COMMA", "LPAREN", "RPAREN", "LBRACKET", "RBRACKET", "SEMICOLON",
+  "LBRACE", "RBRACE",
+  // operators
+  "PLUS", "MINUS", "TIMES", "DIVIDE", "ASSIGN",
+  // comparators
+  "LESS", "GREATER", "LESS_EQ", "GREATER_EQ", "EQUAL", "NOT_EQUAL",
+  // values
+  "INT_VAL", "DOUBLE_VAL", "CHAR_VAL", "STRING_VAL", "BOOL_VAL", "NULL_VAL",
+  // primitive data types
+  "INT_TYPE", "DOUBLE_TYPE", "BOOL_TYPE", "STRING_TYPE", "CHAR_TYPE",
+  "VOID_TYPE",
+  // reserved words
+  "STRUCT", "ARRAY", "FOR", "WHILE", "IF", "ELSEIF", "ELSE", "AND", "OR",
+  "NOT", "NEW", "RETURN", "DELETE"
+};
+
+// returns the printable name of the token type
+constexpr std::string_view token_type_name(TokenType type)
+{
+  return TOKEN_TYPE_NAMES[static_cast<std::uint8_t>(type)];
+}
+
+static_assert(std::size(TOKEN_TYPE_NAMES) ==
+              static_cast<std::size_t>(TokenType::DELETE) + 1);
+static_assert(token_type_name(TokenType::RBRACE) == "RBRACE");
+static_assert(token_type_name(TokenType::NOT_EQUAL) == "NOT_EQUAL");
+static_assert(token_type_name(TokenType::NULL_VAL) == "NULL_VAL");
+static_assert(token_type_name(TokenType::VOID_TYPE) == "VOID_TYPE");
+static_assert(token_type_name(TokenType::DELETE) == "DELETE");
+
+
+// returns the offset at which a token starts given its type and the
+// offset of its lexeme (string and char lexemes omit the opening quote)
+inline std::size_t token_start(TokenType type, std::size_t lexeme_offset)
+{
+  if ((type == TokenType::STRING_VAL) || (type == TokenType::CHAR_VAL))
+    return lexeme_offset - 1;
+  return lexeme_offset;
+}
+
+
+// the value a token was lexed to, which depends on its type
+union TokenValue
+{
+  // interned name of an ID
+  SymbolId symbol;
+  // value of an INT_VAL
+  std::int64_t int_value;
+  // value of a DOUBLE_VAL
+  double double_value;
+};
+
+
+// returns the value of an INT_VAL or DOUBLE_VAL token given its lexeme
+// (for tokens whose value was not kept from lexing)
+TokenValue literal_value(TokenType type, std::string_view lexeme);
+
+
 class Token
 {
 public:
 
   // default constructor
   Token();
-  // constructor
+  // constructor (the token keeps its own copy of the lexeme)
   Token(TokenType type, const std::string& lexeme, int line, int colum);
+  // create a token for the given number of bytes at offset in a
+  // source, without copying them (the token shares ownership of the
+  // source, so it stays valid after the lexer or token buffer it came
+  // from is gone; an ID whose symbol is not given is interned, an EOS
+  // prints as end-of-stream)
+  static Token from_source(TokenType type,
+                           std::shared_ptr<const SourceBuffer> source,
+                           std::size_t offset, std::size_t length,
+                           TokenValue value = {NO_SYMBOL});
   // returns the type of the token
   TokenType type() const;
-  // returns the lexeme of the token
+  // returns a copy of the lexeme of the token
   std::string lexeme() const;
+  // returns the lexeme of the token without copying it
+  std::string_view lexeme_view() const;
+  // returns the interned id of an ID token's name (otherwise NO_SYMBOL)
+  SymbolId symbol() const;
+  // returns the value of an INT_VAL token (otherwise 0)
+  std::int64_t int_value() const;
+  // returns the value of a DOUBLE_VAL token (otherwise 0)
+  double double_value() const;
+  // returns the token's value (as stored, whatever its type)
+  TokenValue value() const;
+  // returns the offset of the lexeme in its source
+  std::size_t offset() const;
   // returns the line of the token
   int line() const;
   // returns the column of the token
   int column() const;
+  // returns the line and column of the token (both are looked up in the
+  // source's line index rather than stored in the token)
+  SourcePosition position() const;
   // returns the token as a printable string
   friend std::string to_string(const Token& token);
 
@@ -52,14 +146,69 @@ private:
 
   // the type of the token
   TokenType token_type;
-  // the token's lexeme
-  std::string token_lexeme;
-  // line the token occurs on
-  int token_line;
-  // starting column of the token
-  int token_column;
+  // true if the source holds just a copy of the lexeme (whose first
+  // line and column are the token's)
+  bool token_copied;
+  // where the token's lexeme is in its source
+  std::uint32_t token_offset;
+  std::uint32_t token_length;
+  // symbol or numeric value, per the type
+  TokenValue token_value;
+  // the source the lexeme (and its position) comes from (shared with
+  // the lexer, or holding just a copied lexeme)
+  std::shared_ptr<const SourceBuffer> token_source;
+
+};
+
+
+// largest lexeme length (or ID symbol) a TokenRef can hold
+const std::uint32_t TOKEN_REF_MAX = (std::uint32_t(1) << 24) - 1;
+
+
+// A token of a parsed program kept as just where its lexeme is in the
+// program's source (8 bytes, rather than a whole Token per AST token).
+// Its lexeme, value, and position are found again through the source.
+class TokenRef
+{
+public:
+
+  // default constructor
+  TokenRef() = default;
+  // create a reference to a token whose lexeme is in the given source
+  // (throws a MyPLException if it is not, or if the lexeme is longer,
+  // or an ID's symbol larger, than TOKEN_REF_MAX). An end-of-stream
+  // token, whose lexeme is not source text, refers to an empty lexeme
+  // at the end of the source.
+  TokenRef(const Token& token, const SourceBuffer& source);
+  // create a reference from its parts (an ID's symbol, otherwise the
+  // length of its lexeme), which must fit TOKEN_REF_MAX
+  TokenRef(TokenType type, std::uint32_t offset, std::uint32_t symbol_or_length);
+  // returns the type of the token
+  TokenType type() const {return static_cast<TokenType>(ref_info & 0xff);}
+  // returns the interned id of an ID token's name (otherwise NO_SYMBOL)
+  SymbolId symbol() const;
+  // returns the offset of the lexeme in its source
+  std::size_t offset() const {return ref_offset;}
+  // returns the lexeme of the token without copying it (an ID's is its
+  // interned name, so needs no source)
+  std::string_view lexeme_view(const SourceBuffer& source) const;
+  // returns a copy of the lexeme of the token
+  std::string lexeme(const SourceBuffer& source) const;
+  // returns the line and column of the token (looked up in the
+  // source's line index)
+  SourcePosition position(const SourceBuffer& source) const;
+
+private:
+
+  // where the token's lexeme is in its source
+  std::uint32_t ref_offset = 0;
+  // the type (low byte) and an ID's symbol or else the lexeme's length
+  // (high three bytes)
+  std::uint32_t ref_info = 0;
 
 };
 
+static_assert(sizeof(TokenRef) == 8);
+
 
 #endif
@@ -0,0 +1,176 @@
+//----------------------------------------------------------------------
+// FILE: token_buffer.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Struct-of-arrays token stream implementation
+//----------------------------------------------------------------------
+
+#include "token_buffer.h"
+
+using namespace std;
+
+
+TokenBuffer::TokenBuffer(shared_ptr<const SourceBuffer> source_buffer)
+  : source {source_buffer}
+{}
+
+
+void TokenBuffer::reserve(size_t count)
+{
+  types.reserve(count);
+  offsets.reserve(count);
+  lengths.reserve(count);
+  values.reserve(count);
+}
+
+
+void TokenBuffer::push_back(const Token& token)
+{
+  types.push_back(token.type());
+  if (token.type() == TokenType::EOS) {
+    offsets.push_back(source->size());
+    lengths.push_back(0);
+  }
+  else {
+    offsets.push_back(token.offset());
+    lengths.push_back(token.lexeme_view().size());
+  }
+  values.push_back(token.value());
+}
+
+
+void TokenBuffer::append(const TokenBuffer& other, size_t count)
+{
+  types.insert(types.end(), other.types.begin(), other.types.begin() + count);
+  offsets.insert(offsets.end(), other.offsets.begin(),
+                 other.offsets.begin() + count);
+  lengths.insert(lengths.end(), other.lengths.begin(),
+                 other.lengths.begin() + count);
+  values.insert(values.end(), other.values.begin(),
+                other.values.begin() + count);
+}
+
+
+void TokenBuffer::append(const TokenBuffer& other, size_t first, size_t last,
+                         ptrdiff_t shift)
+{
+  types.insert(types.end(), other.types.begin() + first,
+               other.types.begin() + last);
+  for (size_t i = first; i < last; ++i)
+    offsets.push_back(other.offsets[i] + shift);
+  lengths.insert(lengths.end(), other.lengths.begin() + first,
+                 other.lengths.begin() + last);
+  values.insert(values.end(), other.values.begin() + first,
+                other.values.begin() + last);
+}
+
+
+void TokenBuffer::set_error(const MyPLException& lexer_error)
+{
+  error = lexer_error;
+}
+
+
+size_t TokenBuffer::size() const
+{
+  return types.size();
+}
+
+
+TokenType TokenBuffer::type(size_t i) const
+{
+  return types[i];
+}
+
+
+uint32_t TokenBuffer::offset(size_t i) const
+{
+  return offsets[i];
+}
+
+
+uint32_t TokenBuffer::length(size_t i) const
+{
+  return lengths[i];
+}
+
+
+uint32_t TokenBuffer::line(size_t i) const
+{
+  return position(i).line;
+}
+
+
+uint32_t TokenBuffer::column(size_t i) const
+{
+  return position(i).column;
+}
+
+
+SourcePosition TokenBuffer::position(size_t i) const
+{
+  return source->position(token_start(types[i], offsets[i]));
+}
+
+
+SymbolId TokenBuffer::symbol(size_t i) const
+{
+  if (types[i] != TokenType::ID)
+    return NO_SYMBOL;
+  return values[i].symbol;
+}
+
+
+int64_t TokenBuffer::int_value(size_t i) const
+{
+  if (types[i] != TokenType::INT_VAL)
+    return 0;
+  return values[i].int_value;
+}
+
+
+double TokenBuffer::double_value(size_t i) const
+{
+  if (types[i] != TokenType::DOUBLE_VAL)
+    return 0;
+  return values[i].double_value;
+}
+
+
+string_view TokenBuffer::lexeme(size_t i) const
+{
+  if (types[i] == TokenType::EOS)
+    return "end-of-stream";
+  return string_view(source->begin() + offsets[i], lengths[i]);
+}
+
+
+Token TokenBuffer::token(size_t i) const
+{
+  return Token::from_source(types[i], source, offsets[i], lengths[i],
+                            values[i]);
+}
+
+
+bool TokenBuffer::has_error() const
+{
+  return error.has_value();
+}
+
+
+void TokenBuffer::throw_error() const
+{
+  throw *error;
+}
+
+
+const optional<MyPLException>& TokenBuffer::lexer_error() const
+{
+  return error;
+}
+
+
+shared_ptr<const SourceBuffer> TokenBuffer::source_buffer() const
+{
+  return source;
+}
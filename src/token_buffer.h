@@ -0,0 +1,103 @@
+//----------------------------------------------------------------------
+// FILE: token_buffer.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Struct-of-arrays storage for a fully lexed token stream
+//----------------------------------------------------------------------
+
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "interner.h"
+#include "mypl_exception.h"
+#include "source_buffer.h"
+#include "token.h"
+
+
+class TokenBuffer
+{
+public:
+
+  // create an empty buffer for tokens of the given source text
+  TokenBuffer(std::shared_ptr<const SourceBuffer> source_buffer);
+
+  // reserve room for the given number of tokens
+  void reserve(std::size_t count);
+
+  // append a token whose lexeme is in this buffer's source (for EOS,
+  // the offset is the end of the source)
+  void push_back(const Token& token);
+
+  // append the first count tokens of other (which must share this
+  // buffer's source)
+  void append(const TokenBuffer& other, std::size_t count);
+
+  // append tokens [first, last) of other, moving their offsets by shift
+  // (e.g., tokens after an edit of other's source)
+  void append(const TokenBuffer& other, std::size_t first, std::size_t last,
+              std::ptrdiff_t shift);
+
+  // record the lexer error that stopped the token stream early
+  void set_error(const MyPLException& error);
+
+  // number of tokens in the buffer (including EOS, if lexing finished)
+  std::size_t size() const;
+
+  // per-token fields
+  TokenType type(std::size_t i) const;
+  std::uint32_t offset(std::size_t i) const;
+  std::uint32_t length(std::size_t i) const;
+  std::uint32_t line(std::size_t i) const;
+  std::uint32_t column(std::size_t i) const;
+  SourcePosition position(std::size_t i) const;
+  SymbolId symbol(std::size_t i) const;
+  std::int64_t int_value(std::size_t i) const;
+  double double_value(std::size_t i) const;
+
+  // the lexeme of the i-th token (a view into the source)
+  std::string_view lexeme(std::size_t i) const;
+
+  // the i-th token as a Token object
+  Token token(std::size_t i) const;
+
+  // true if lexing stopped at an error instead of reaching EOS
+  bool has_error() const;
+
+  // rethrow the lexer error that stopped the token stream
+  [[noreturn]] void throw_error() const;
+
+  // the lexer error that stopped the token stream (if any)
+  const std::optional<MyPLException>& lexer_error() const;
+
+  // the source text the buffer's offsets refer to
+  std::shared_ptr<const SourceBuffer> source_buffer() const;
+
+private:
+
+  // read (and write) the arrays directly
+  friend class TokenCache;
+  friend class TokenCursor;
+
+  std::shared_ptr<const SourceBuffer> source;
+
+  // parallel per-token arrays (lines and columns come from the source's
+  // line index)
+  std::vector<TokenType> types;
+  std::vector<std::uint32_t> offsets;
+  std::vector<std::uint32_t> lengths;
+  // side table of symbols and numeric values (per the token's type)
+  std::vector<TokenValue> values;
+
+  // error that ended lexing early (if any)
+  std::optional<MyPLException> error;
+
+};
+
+
+#endif
@@ -0,0 +1,294 @@
+//----------------------------------------------------------------------
+// FILE: token_cache.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: On-disk cache of lexed tokens keyed by a hash of the source
+//----------------------------------------------------------------------
+
+// A .tok file is a header followed by the token buffer's arrays, the
+// identifier names, the lexer error message (if any), and a copy of the
+// source text:
+//
+//   header | values | offsets | lengths | types | name lengths | names
+//          | error | source
+//
+// The hash only names the file, and the source is compared byte for
+// byte before the tokens are used.
+//
+// Interned symbols differ from run to run, so the values of ID tokens
+// hold the index of their name in the file, and the names are
+// re-interned (once each) on loading. Everything is stored in the
+// machine's byte order (a file from a machine with a different order
+// fails the format check).
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "lexer.h"
+#include "parallel_lexer.h"
+#include "token_cache.h"
+
+using namespace std;
+
+
+// the fixed-size start of a .tok file
+struct TokenCacheHeader
+{
+  char magic[8];
+  uint32_t format;
+  uint32_t lexer_version;
+  uint64_t source_hash;
+  uint64_t source_size;
+  uint64_t token_count;
+  // number of distinct identifier names and their total length
+  uint64_t name_count;
+  uint64_t names_size;
+  // length of the lexer error message (0 if lexing reached EOS)
+  uint64_t error_size;
+};
+
+static_assert(sizeof(TokenCacheHeader) == 64);
+static_assert(sizeof(TokenValue) == 8);
+static_assert(sizeof(TokenType) == 1);
+
+const char TOKEN_CACHE_MAGIC[8] = {'M', 'Y', 'P', 'L', 'T', 'O', 'K', '\0'};
+
+
+// total size of a .tok file with the given header
+static size_t file_size(const TokenCacheHeader& header)
+{
+  size_t per_token = sizeof(TokenValue) + 2 * sizeof(uint32_t) +
+    sizeof(TokenType);
+  return sizeof(TokenCacheHeader) + header.token_count * per_token +
+    header.name_count * sizeof(uint32_t) + header.names_size +
+    header.error_size + header.source_size;
+}
+
+
+// copy size bytes to (or from) the file position p and advance it
+static void put(char*& p, const void* src, size_t size)
+{
+  if (size > 0)
+    memcpy(p, src, size);
+  p += size;
+}
+
+static void take(const char*& p, void* dest, size_t size)
+{
+  if (size > 0)
+    memcpy(dest, p, size);
+  p += size;
+}
+
+
+uint64_t hash_bytes(const char* data, size_t size)
+{
+  // MurmurHash64A, eight bytes at a time
+  const uint64_t m = 0xc6a4a7935bd1e995ull;
+  const int r = 47;
+  uint64_t h = 0x6d79706c746f6b31ull ^ (size * m);
+  const char* end = data + (size & ~size_t(7));
+  for (const char* p = data; p != end; p += 8) {
+    uint64_t k;
+    memcpy(&k, p, 8);
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  if (size & 7) {
+    uint64_t tail = 0;
+    memcpy(&tail, end, size & 7);
+    h ^= tail;
+    h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+
+TokenCache::TokenCache(const string& directory)
+  : directory {directory}
+{}
+
+
+string TokenCache::path(uint64_t source_hash) const
+{
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.tok",
+           static_cast<unsigned long long>(source_hash));
+  return directory + "/" + name;
+}
+
+
+TokenBuffer TokenCache::tokenize(shared_ptr<const SourceBuffer> source) const
+{
+  uint64_t source_hash = hash_bytes(source->begin(), source->size());
+  optional<TokenBuffer> cached = load(source, source_hash);
+  if (cached)
+    return move(*cached);
+  TokenBuffer tokens = tokenize_parallel(source);
+  store(tokens, source_hash); // a cache that cannot be written is skipped
+  return tokens;
+}
+
+
+optional<TokenBuffer>
+TokenCache::load(shared_ptr<const SourceBuffer> source) const
+{
+  return load(source, hash_bytes(source->begin(), source->size()));
+}
+
+
+bool TokenCache::store(const TokenBuffer& tokens) const
+{
+  shared_ptr<const SourceBuffer> source = tokens.source_buffer();
+  return store(tokens, hash_bytes(source->begin(), source->size()));
+}
+
+
+optional<TokenBuffer> TokenCache::load(shared_ptr<const SourceBuffer> source,
+                                       uint64_t source_hash) const
+{
+  // map the file (it is never modified in place, only replaced)
+  shared_ptr<SourceBuffer> file =
+    SourceBuffer::from_file(path(source_hash), SIZE_MAX);
+  if (!file || (file->size() < sizeof(TokenCacheHeader)))
+    return nullopt;
+  const char* p = file->begin();
+  TokenCacheHeader header;
+  take(p, &header, sizeof(header));
+  uint64_t size = source->size();
+  if ((memcmp(header.magic, TOKEN_CACHE_MAGIC, sizeof(header.magic)) != 0) ||
+      (header.format != TOKEN_CACHE_FORMAT) ||
+      (header.lexer_version != LEXER_VERSION) ||
+      (header.source_hash != source_hash) || (header.source_size != size))
+    return nullopt;
+  // every token but EOS has at least one character (which also keeps
+  // the file size from overflowing)
+  if ((header.token_count > size + 1) ||
+      (header.name_count > header.token_count) ||
+      (header.names_size > size) || (header.error_size > file->size()) ||
+      (file_size(header) != file->size()))
+    return nullopt;
+  // the file must be for this very source (not one with the same hash)
+  if (memcmp(file->end() - size, source->begin(), size) != 0)
+    return nullopt;
+
+  size_t count = header.token_count;
+  TokenBuffer tokens(source);
+  tokens.values.resize(count);
+  tokens.offsets.resize(count);
+  tokens.lengths.resize(count);
+  tokens.types.resize(count);
+  take(p, tokens.values.data(), count * sizeof(TokenValue));
+  take(p, tokens.offsets.data(), count * sizeof(uint32_t));
+  take(p, tokens.lengths.data(), count * sizeof(uint32_t));
+  take(p, tokens.types.data(), count * sizeof(TokenType));
+
+  // intern the names once each
+  vector<uint32_t> name_lengths(header.name_count);
+  take(p, name_lengths.data(), name_lengths.size() * sizeof(uint32_t));
+  vector<SymbolId> symbols;
+  symbols.reserve(name_lengths.size());
+  size_t used = 0;
+  for (uint32_t length : name_lengths) {
+    if (length > header.names_size - used)
+      return nullopt;
+    symbols.push_back(Interner::global().intern(string_view(p + used,
+                                                            length)));
+    used += length;
+  }
+  if (used != header.names_size)
+    return nullopt;
+  p += used;
+
+  // check that every lexeme is in the source and restore the symbols
+  for (size_t i = 0; i < count; ++i) {
+    if ((tokens.types[i] > TokenType::DELETE) || (tokens.offsets[i] > size) ||
+        (tokens.lengths[i] > size - tokens.offsets[i]))
+      return nullopt;
+    if (tokens.types[i] == TokenType::ID) {
+      if (tokens.values[i].symbol >= symbols.size())
+        return nullopt;
+      tokens.values[i].symbol = symbols[tokens.values[i].symbol];
+    }
+  }
+
+  if (header.error_size > 0)
+    tokens.error = MyPLException(string(p, header.error_size));
+  return tokens;
+}
+
+
+bool TokenCache::store(const TokenBuffer& tokens, uint64_t source_hash) const
+{
+  // number the distinct names in order of first use, and clear the
+  // values of other tokens (so equal sources give equal files)
+  size_t count = tokens.size();
+  vector<TokenValue> values(tokens.values);
+  unordered_map<SymbolId, uint32_t> indexes;
+  vector<string_view> names;
+  size_t names_size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    TokenType type = tokens.types[i];
+    if (type == TokenType::ID) {
+      auto [it, added] = indexes.try_emplace(values[i].symbol, names.size());
+      if (added) {
+        names.push_back(Interner::global().name(values[i].symbol));
+        names_size += names.back().size();
+      }
+      values[i].int_value = 0;
+      values[i].symbol = it->second;
+    }
+    else if ((type != TokenType::INT_VAL) && (type != TokenType::DOUBLE_VAL))
+      values[i].int_value = 0;
+  }
+  string error = tokens.has_error() ? tokens.lexer_error()->what() : "";
+
+  TokenCacheHeader header;
+  memcpy(header.magic, TOKEN_CACHE_MAGIC, sizeof(header.magic));
+  header.format = TOKEN_CACHE_FORMAT;
+  header.lexer_version = LEXER_VERSION;
+  header.source_hash = source_hash;
+  header.source_size = tokens.source_buffer()->size();
+  header.token_count = count;
+  header.name_count = names.size();
+  header.names_size = names_size;
+  header.error_size = error.size();
+
+  vector<char> file(file_size(header));
+  char* p = file.data();
+  put(p, &header, sizeof(header));
+  put(p, values.data(), count * sizeof(TokenValue));
+  put(p, tokens.offsets.data(), count * sizeof(uint32_t));
+  put(p, tokens.lengths.data(), count * sizeof(uint32_t));
+  put(p, tokens.types.data(), count * sizeof(TokenType));
+  for (string_view name : names) {
+    uint32_t length = name.size();
+    put(p, &length, sizeof(length));
+  }
+  for (string_view name : names)
+    put(p, name.data(), name.size());
+  put(p, error.data(), error.size());
+  put(p, tokens.source_buffer()->begin(), header.source_size);
+
+  // write a private temporary file, then rename it over the cache file
+  // (atomically, so readers see either the old file or the new one)
+  string final_path = path(source_hash);
+  string temp_path = final_path + ".tmp" + to_string(random_device()());
+  ofstream out(temp_path, ios::binary | ios::trunc);
+  out.write(file.data(), file.size());
+  out.close();
+  if (out.fail() || (rename(temp_path.c_str(), final_path.c_str()) != 0)) {
+    remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
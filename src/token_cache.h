@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------
+// FILE: token_cache.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: On-disk cache of lexed tokens keyed by a hash of the source
+//----------------------------------------------------------------------
+
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include "source_buffer.h"
+#include "token_buffer.h"
+
+
+// version of the .tok file layout (bumped whenever it changes)
+const std::uint32_t TOKEN_CACHE_FORMAT = 2;
+
+
+// Returns a 64-bit hash of the bytes (the same across runs and builds
+// on machines with the same byte order)
+std::uint64_t hash_bytes(const char* data, std::size_t size);
+
+
+// A directory of .tok files, each holding the tokens of one source text
+// and named by the hash of its bytes. A file is only used if it was
+// written by the same lexer version for the same source text (each file
+// holds a copy of its source, so sources whose hashes collide never
+// share tokens). Files are written under a temporary name and renamed into
+// place, so concurrent readers (and writers) only ever see complete
+// files.
+class TokenCache
+{
+public:
+
+  // create a cache in the given (existing) directory
+  TokenCache(const std::string& directory);
+
+  // returns the tokens of the source, loaded from the cache if it holds
+  // them, otherwise lexed (and then stored in the cache if possible)
+  TokenBuffer tokenize(std::shared_ptr<const SourceBuffer> source) const;
+
+  // returns the cached tokens of the source (if any)
+  std::optional<TokenBuffer>
+  load(std::shared_ptr<const SourceBuffer> source) const;
+
+  // writes the tokens (of their source) to the cache, returns false if
+  // they could not be written
+  bool store(const TokenBuffer& tokens) const;
+
+  // returns the path of the cache file for a source with the given hash
+  std::string path(std::uint64_t source_hash) const;
+
+private:
+
+  std::string directory;
+
+  // load and store given the hash of the source
+  std::optional<TokenBuffer> load(std::shared_ptr<const SourceBuffer> source,
+                                  std::uint64_t source_hash) const;
+  bool store(const TokenBuffer& tokens, std::uint64_t source_hash) const;
+
+};
+
+
+#endif
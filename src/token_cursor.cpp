@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------
+// FILE: token_cursor.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: A parser's position in a token stream (lexed as it goes or
+//       already lexed into a token buffer)
+//----------------------------------------------------------------------
+
+#include "token_cursor.h"
+
+using namespace std;
+
+
+TokenCursor::TokenCursor(const Lexer& a_lexer)
+  : lexer {a_lexer}
+{}
+
+
+TokenCursor::TokenCursor(shared_ptr<const TokenBuffer> tokens)
+  : TokenCursor(tokens, 0, tokens->size())
+{}
+
+
+TokenCursor::TokenCursor(shared_ptr<const TokenBuffer> tokens, size_t a_first,
+                         size_t a_last)
+  : buffer {move(tokens)}, first {a_first}, last {a_last}, next {a_first}
+{
+  types = buffer->types.data();
+  ends_in_error = buffer->has_error() && (last == buffer->size());
+}
+
+
+void TokenCursor::advance()
+{
+  if (buffer) {
+    // a whole buffer's last token is EOS unless lexing stopped at an
+    // error, while a range of tokens may end anywhere
+    if (next < last)
+      curr_type = types[next++];
+    else if (ends_in_error)
+      buffer->throw_error();
+    else
+      curr_type = TokenType::EOS;
+    return;
+  }
+  if (lookahead.empty())
+    curr_token = lexer->next_token();
+  else {
+    curr_token = move(lookahead.front());
+    lookahead.pop_front();
+  }
+  curr_type = curr_token.type();
+}
+
+
+Token TokenCursor::token() const
+{
+  if (!buffer)
+    return curr_token;
+  if ((next > first) && (types[next - 1] == curr_type))
+    return buffer->token(next - 1);
+  // an EOS that is not in the buffer (before the range or past its end)
+  shared_ptr<const SourceBuffer> source = buffer->source_buffer();
+  size_t offset = source->size();
+  if (next < buffer->size())
+    offset = token_start(types[next], buffer->offset(next));
+  return Token::from_source(TokenType::EOS, move(source), offset, 0);
+}
+
+
+TokenType TokenCursor::peek(size_t n)
+{
+  if (n == 0)
+    return curr_type;
+  if (buffer) {
+    size_t i = next + n - 1;
+    if (i < last)
+      return types[i];
+    if (ends_in_error)
+      buffer->throw_error();
+    return TokenType::EOS;
+  }
+  while (lookahead.size() < n)
+    lookahead.push_back(lexer->next_token());
+  return lookahead[n - 1].type();
+}
+
+
+shared_ptr<const SourceBuffer> TokenCursor::source_buffer() const
+{
+  if (buffer)
+    return buffer->source_buffer();
+  return lexer->source_buffer();
+}
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------
+// FILE: token_cursor.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: A parser's position in a token stream (lexed as it goes or
+//       already lexed into a token buffer)
+//----------------------------------------------------------------------
+
+#ifndef TOKEN_CURSOR_H
+#define TOKEN_CURSOR_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include "lexer.h"
+#include "source_buffer.h"
+#include "token.h"
+#include "token_buffer.h"
+
+
+// The current token of a parse. Over a token buffer, moving to the
+// next token is an index increment and the current type is a byte in
+// the buffer (the Token itself is only built when asked for). Over a
+// lexer, tokens are lexed one at a time (so a streaming lexer keeps
+// memory use bounded), and only peeked tokens are held.
+class TokenCursor
+{
+public:
+
+  // create a cursor that lexes the tokens as it goes
+  TokenCursor(const Lexer& lexer);
+
+  // create a cursor over already lexed tokens (whose error, if any, is
+  // thrown when the cursor reaches it)
+  TokenCursor(std::shared_ptr<const TokenBuffer> tokens);
+
+  // create a cursor over just the tokens [first, last) of a buffer,
+  // followed by EOS (or the buffer's error, if last is its end)
+  TokenCursor(std::shared_ptr<const TokenBuffer> tokens, std::size_t first,
+              std::size_t last);
+
+  // move to the next token (the first call moves to the first token),
+  // staying on EOS once there
+  void advance();
+
+  // type of the current token
+  TokenType type() const {return curr_type;}
+
+  // the current token
+  Token token() const;
+
+  // type of the token n tokens after the current one (EOS past the
+  // end), throwing a lexer error if the lookahead reaches one
+  TokenType peek(std::size_t n);
+
+  // the source the tokens' lexemes refer to
+  std::shared_ptr<const SourceBuffer> source_buffer() const;
+
+private:
+
+  TokenType curr_type = TokenType::EOS;
+
+  // buffered tokens (if any), their types, the range of them to parse,
+  // the index just past the current token, and whether the range ends
+  // at the buffer's error
+  std::shared_ptr<const TokenBuffer> buffer;
+  const TokenType* types = nullptr;
+  std::size_t first = 0;
+  std::size_t last = 0;
+  std::size_t next = 0;
+  bool ends_in_error = false;
+
+  // lexer (if not buffered), its current token, and the tokens lexed
+  // ahead of it by peek
+  std::optional<Lexer> lexer;
+  Token curr_token;
+  std::deque<Token> lookahead;
+
+};
+
+
+#endif
@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------
+// FILE: token_writer.cpp
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Bulk token dump writer implementation
+//----------------------------------------------------------------------
+
+#include <charconv>
+#include <cstring>
+#include "token_writer.h"
+
+using namespace std;
+
+// bytes formatted before each write to the stream
+const size_t OUTPUT_BLOCK_SIZE = 1 << 20;
+
+
+TokenWriter::TokenWriter(ostream& out)
+  : out {out}, buffer(OUTPUT_BLOCK_SIZE)
+{}
+
+
+TokenWriter::~TokenWriter()
+{
+  flush();
+}
+
+
+void TokenWriter::write(const Token& token)
+{
+  put(token.position(), token.type(), token.lexeme_view());
+}
+
+
+void TokenWriter::write(const TokenBuffer& tokens)
+{
+  shared_ptr<const SourceBuffer> source = tokens.source_buffer();
+  size_t line = 0; // tokens are in source order, so lines only advance
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    TokenType type = tokens.type(i);
+    put(source->position(token_start(type, tokens.offset(i)), line), type,
+        tokens.lexeme(i));
+  }
+}
+
+
+void TokenWriter::flush()
+{
+  out.write(buffer.data(), used);
+  used = 0;
+  out.flush();
+}
+
+
+void TokenWriter::put(string_view text)
+{
+  if (used + text.size() > buffer.size()) {
+    out.write(buffer.data(), used);
+    used = 0;
+    if (text.size() > buffer.size()) {
+      out.write(text.data(), text.size());
+      return;
+    }
+  }
+  memcpy(buffer.data() + used, text.data(), text.size());
+  used += text.size();
+}
+
+
+void TokenWriter::put(int n)
+{
+  char digits[16];
+  char* end = to_chars(digits, digits + sizeof(digits), n).ptr;
+  put(string_view(digits, end - digits));
+}
+
+
+void TokenWriter::put(const SourcePosition& pos, TokenType type,
+                      string_view lexeme)
+{
+  put(pos.line);
+  put(", ");
+  put(pos.column);
+  put(": ");
+  put(token_type_name(type));
+  put(" '");
+  put(lexeme);
+  put("'\n");
+}
+
+
+void write_tokens(const TokenBuffer& tokens, ostream& out)
+{
+  TokenWriter writer(out);
+  writer.write(tokens);
+}
+
+
+void write_tokens(Lexer& lexer, ostream& out)
+{
+  TokenWriter writer(out); // flushed even if the lexer throws
+  Token token;
+  do {
+    token = lexer.next_token();
+    writer.write(token);
+  } while (token.type() != TokenType::EOS);
+}
@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------
+// FILE: token_writer.h
+// DATE: CPSC 326, Spring 2023
+// AUTH: Ian Myers
+// DESC: Bulk token dump writer (used by --lex)
+//----------------------------------------------------------------------
+
+#ifndef TOKEN_WRITER_H
+#define TOKEN_WRITER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+#include "token.h"
+#include "token_buffer.h"
+
+
+// Writes tokens one per line in the format of to_string(Token). The
+// lines are formatted into a large buffer that is written out a block
+// at a time (and when the writer is flushed or destroyed).
+class TokenWriter
+{
+public:
+
+  // create a writer to the given stream
+  TokenWriter(std::ostream& out);
+
+  // writes out anything still buffered
+  ~TokenWriter();
+
+  // write a single token
+  void write(const Token& token);
+
+  // write every token in the buffer
+  void write(const TokenBuffer& tokens);
+
+  // write out the buffered text and flush the stream
+  void flush();
+
+private:
+
+  std::ostream& out;
+
+  // formatted text not yet written to out
+  std::vector<char> buffer;
+  std::size_t used = 0;
+
+  // append the text (writing it directly if it is larger than the buffer)
+  void put(std::string_view text);
+
+  // append the decimal digits of n
+  void put(int n);
+
+  // append a token's line
+  void put(const SourcePosition& pos, TokenType type, std::string_view lexeme);
+
+};
+
+
+// Write every token in the buffer to out and flush it
+void write_tokens(const TokenBuffer& tokens, std::ostream& out);
+
+// Write every token of the lexer (up to and including EOS) to out as it
+// is lexed and flush it (the tokens before an error are written before
+// the error is thrown)
+void write_tokens(Lexer& lexer, std::ostream& out);
+
+
+#endif
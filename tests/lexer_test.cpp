@@ -6,11 +6,20 @@
 //----------------------------------------------------------------------
 
 #include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <string>
 #include <vector>
 #include "mypl_exception.h"
 #include "token.h"
+#include "source_buffer.h"
+#include "stream_source.h"
 #include "lexer.h"
+#include "parallel_lexer.h"
+#include "token_writer.h"
+#include "token_cache.h"
+#include "incremental_lexer.h"
 
 
 using namespace std;
@@ -371,6 +380,11 @@ TEST(BasicLexerTest, ComplexTypeReservedWords) {
   ASSERT_EQ(1, t.line());
   ASSERT_EQ(8, t.column());
   t = lexer.next_token();
+  ASSERT_EQ(TokenType::DELETE, t.type());
+  ASSERT_EQ("delete", t.lexeme());
+  ASSERT_EQ(1, t.line());
+  ASSERT_EQ(14, t.column());
+  t = lexer.next_token();
   ASSERT_EQ(TokenType::EOS, t.type());
 }
 
@@ -524,6 +538,454 @@ TEST(BasicLexerTest, NoSpacesNumbers) {
   ASSERT_EQ(TokenType::EOS, t.type());
 }
 
+TEST(BasicLexerTest, LongRunsOfBlankAndCommentLines) {
+  string text;
+  for (int i = 0; i < 200000; ++i)
+    text += "    # comment\n\n";
+  text += "  x";
+  stringstream in(text);
+  Lexer lexer(in);
+  Token t = lexer.next_token();
+  ASSERT_EQ(TokenType::ID, t.type());
+  ASSERT_EQ(400001, t.line());
+  ASSERT_EQ(3, t.column());
+  ASSERT_EQ(TokenType::EOS, lexer.next_token().type());
+}
+
+TEST(BasicLexerTest, RunsAcrossScanBlockBoundaries) {
+  for (int n = 0; n < 80; ++n) {
+    string pad(n, ' ');
+    string word = "w" + string(n, 'x');
+    string str(n, 's');
+    string text = pad + "\n" + pad + "# " + string(n, '#') + "\n" + word +
+      " \"" + str + "\" " + "1" + string(n, '0') + ".5" + pad;
+    stringstream in(text);
+    Lexer lexer(in);
+    Token t = lexer.next_token();
+    ASSERT_EQ(TokenType::ID, t.type());
+    ASSERT_EQ(word, t.lexeme());
+    ASSERT_EQ(3, t.line());
+    ASSERT_EQ(1, t.column());
+    t = lexer.next_token();
+    ASSERT_EQ(TokenType::STRING_VAL, t.type());
+    ASSERT_EQ(str, t.lexeme());
+    ASSERT_EQ(n + 3, t.column());
+    t = lexer.next_token();
+    ASSERT_EQ(TokenType::DOUBLE_VAL, t.type());
+    ASSERT_EQ(n + 3, t.lexeme().size());
+    ASSERT_EQ(2 * n + 6, t.column());
+    t = lexer.next_token();
+    ASSERT_EQ(TokenType::EOS, t.type());
+    ASSERT_EQ(3, t.line());
+    ASSERT_EQ(4 * n + 9, t.column());
+  }
+}
+
+TEST(BasicLexerTest, LexemesViewSourceText) {
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string("x1 \"hi\" 'c'");
+  Lexer lexer(source);
+  Token t = lexer.next_token();
+  ASSERT_EQ("x1", t.lexeme_view());
+  ASSERT_EQ(source->begin(), t.lexeme_view().data());
+  t = lexer.next_token();
+  ASSERT_EQ("hi", t.lexeme_view());
+  ASSERT_EQ(source->begin() + 4, t.lexeme_view().data());
+  t = lexer.next_token();
+  ASSERT_EQ("c", t.lexeme_view());
+  ASSERT_EQ(source->begin() + 9, t.lexeme_view().data());
+  ASSERT_EQ(TokenType::EOS, lexer.next_token().type());
+}
+
+TEST(BasicLexerTest, TokenizeAll) {
+  stringstream in("x = 42\n  \"hi\"");
+  Lexer lexer(in);
+  TokenBuffer tokens = lexer.tokenize_all();
+  ASSERT_FALSE(tokens.has_error());
+  ASSERT_EQ(5, tokens.size());
+  vector<TokenType> types = {TokenType::ID, TokenType::ASSIGN,
+    TokenType::INT_VAL, TokenType::STRING_VAL, TokenType::EOS};
+  for (size_t i = 0; i < types.size(); ++i)
+    ASSERT_EQ(types[i], tokens.type(i));
+  ASSERT_EQ("42", tokens.lexeme(2));
+  ASSERT_EQ(4, tokens.offset(2));
+  ASSERT_EQ(2, tokens.length(2));
+  ASSERT_EQ("hi", tokens.lexeme(3));
+  ASSERT_EQ(2, tokens.line(3));
+  ASSERT_EQ(3, tokens.column(3));
+  Token t = tokens.token(4);
+  ASSERT_EQ(TokenType::EOS, t.type());
+  ASSERT_EQ(2, t.line());
+  ASSERT_EQ(7, t.column());
+}
+
+TEST(BasicLexerTest, TokenizeAllStopsAtError) {
+  stringstream in("x ? y");
+  Lexer lexer(in);
+  TokenBuffer tokens = lexer.tokenize_all();
+  ASSERT_TRUE(tokens.has_error());
+  ASSERT_EQ(1, tokens.size());
+  try {
+    tokens.throw_error();
+    FAIL();
+  } catch(MyPLException& e) {
+    string m = e.what();
+    ASSERT_EQ("Lexer Error: unexpected character '?' at line 1, column 3", m);
+  }
+}
+
+TEST(BasicLexerTest, TokensOutliveTheirLexer) {
+  // a token shares its source, so stays valid without the lexer or
+  // token buffer (and the source) it came from
+  Token lexed;
+  Token buffered;
+  {
+    Lexer lexer(SourceBuffer::from_string("x =\n  42"));
+    lexed = lexer.next_token();
+    TokenBuffer tokens = Lexer(SourceBuffer::from_string("y =\n  4.5"))
+      .tokenize_all();
+    buffered = tokens.token(2);
+  }
+  ASSERT_EQ("x", lexed.lexeme());
+  ASSERT_EQ(1, lexed.line());
+  ASSERT_EQ("4.5", buffered.lexeme());
+  ASSERT_EQ(2, buffered.line());
+  ASSERT_EQ(3, buffered.column());
+  ASSERT_EQ(4.5, buffered.double_value());
+}
+
+void expect_same_tokens(const TokenBuffer& expected, const TokenBuffer& actual)
+{
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected.type(i), actual.type(i));
+    ASSERT_EQ(expected.offset(i), actual.offset(i));
+    ASSERT_EQ(expected.length(i), actual.length(i));
+    ASSERT_EQ(expected.line(i), actual.line(i));
+    ASSERT_EQ(expected.column(i), actual.column(i));
+    ASSERT_EQ(expected.symbol(i), actual.symbol(i));
+    ASSERT_EQ(expected.int_value(i), actual.int_value(i));
+    ASSERT_EQ(expected.double_value(i), actual.double_value(i));
+  }
+  ASSERT_EQ(expected.has_error(), actual.has_error());
+  if (expected.has_error()) {
+    ASSERT_EQ(string(expected.lexer_error()->what()),
+              string(actual.lexer_error()->what()));
+  }
+}
+
+TEST(BasicLexerTest, ParallelMatchesSerial) {
+  string text;
+  for (int i = 0; i < 500; ++i)
+    text += "int f" + to_string(i) + "(int x) {  # comment\n"
+      "  return x * 2.5 + '\\n\n\n  \"s\" \n}\n";
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string(text);
+  TokenBuffer serial = Lexer(source).tokenize_all();
+  for (unsigned threads : {2, 3, 7, 16}) {
+    TokenBuffer parallel = tokenize_parallel(source, threads, 64);
+    expect_same_tokens(serial, parallel);
+  }
+}
+
+TEST(BasicLexerTest, ParallelReportsFirstError) {
+  string text;
+  for (int i = 0; i < 200; ++i)
+    text += "x = y + 1\n";
+  text += "z = ?\n";
+  for (int i = 0; i < 200; ++i)
+    text += "x = ! y\n";
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string(text);
+  TokenBuffer serial = Lexer(source).tokenize_all();
+  ASSERT_TRUE(serial.has_error());
+  expect_same_tokens(serial, tokenize_parallel(source, 4, 64));
+}
+
+TEST(BasicLexerTest, IdentifiersShareSymbols) {
+  stringstream in("foo bar foo int\nbar");
+  Lexer lexer(in);
+  TokenBuffer tokens = lexer.tokenize_all();
+  ASSERT_EQ(6, tokens.size());
+  ASSERT_NE(NO_SYMBOL, tokens.symbol(0));
+  ASSERT_NE(tokens.symbol(0), tokens.symbol(1));
+  ASSERT_EQ(tokens.symbol(0), tokens.symbol(2));
+  ASSERT_EQ(tokens.symbol(1), tokens.symbol(4));
+  ASSERT_EQ(NO_SYMBOL, tokens.symbol(3));
+  ASSERT_EQ(NO_SYMBOL, tokens.symbol(5));
+  ASSERT_EQ("foo", Interner::global().name(tokens.symbol(0)));
+  ASSERT_EQ(tokens.symbol(1), Interner::global().find("bar"));
+  // tokens built from strings are interned into the same ids
+  ASSERT_EQ(tokens.symbol(0), Token(TokenType::ID, "foo", 1, 1).symbol());
+  ASSERT_EQ(tokens.symbol(1), tokens.token(1).symbol());
+}
+
+TEST(BasicLexerTest, PositionsComeFromLineIndex) {
+  // the unterminated '\n swallows the newline, but x is still on line 2
+  shared_ptr<SourceBuffer> source =
+    SourceBuffer::from_string("'\\n\nx \"s\" 'c'\n\n  y\n");
+  Lexer lexer(source);
+  Token t = lexer.next_token();
+  ASSERT_EQ(TokenType::CHAR_VAL, t.type());
+  ASSERT_EQ(1, t.line());
+  ASSERT_EQ(1, t.column());
+  t = lexer.next_token();
+  ASSERT_EQ("x", t.lexeme_view());
+  ASSERT_EQ(2, t.line());
+  ASSERT_EQ(1, t.column());
+  t = lexer.next_token();
+  ASSERT_EQ("s", t.lexeme_view());
+  ASSERT_EQ(2, t.line());
+  ASSERT_EQ(3, t.column());
+  t = lexer.next_token();
+  ASSERT_EQ("c", t.lexeme_view());
+  ASSERT_EQ(2, t.line());
+  ASSERT_EQ(7, t.column());
+  t = lexer.next_token();
+  ASSERT_EQ("y", t.lexeme_view());
+  ASSERT_EQ(4, t.line());
+  ASSERT_EQ(3, t.column());
+  t = lexer.next_token();
+  ASSERT_EQ(TokenType::EOS, t.type());
+  ASSERT_EQ(5, t.line());
+  ASSERT_EQ(1, t.column());
+  // tokens made from strings keep the position they were given
+  Token u(TokenType::ID, "z", 7, 9);
+  ASSERT_EQ(7, u.line());
+  ASSERT_EQ(9, u.column());
+}
+
+TEST(BasicLexerTest, NumericValues) {
+  stringstream in("0 42 9223372036854775807 3.25 0.1 x");
+  Lexer lexer(in);
+  TokenBuffer tokens = lexer.tokenize_all();
+  ASSERT_FALSE(tokens.has_error());
+  ASSERT_EQ(0, tokens.int_value(0));
+  ASSERT_EQ(42, tokens.int_value(1));
+  ASSERT_EQ(9223372036854775807, tokens.int_value(2));
+  ASSERT_EQ(3.25, tokens.double_value(3));
+  ASSERT_EQ(0.1, tokens.double_value(4));
+  ASSERT_EQ(0, tokens.int_value(5));
+  Token t = tokens.token(1);
+  ASSERT_EQ(42, t.int_value());
+  ASSERT_EQ(0, t.double_value());
+  ASSERT_EQ(3.25, tokens.token(3).double_value());
+  ASSERT_EQ(7, Token(TokenType::INT_VAL, "7", 1, 1).int_value());
+  ASSERT_EQ(2.5, Token(TokenType::DOUBLE_VAL, "2.5", 1, 1).double_value());
+}
+
+TEST(BasicLexerTest, WriteTokensMatchesToString) {
+  string text = "struct S {\n  int x; # comment\n}\n";
+  for (int i = 0; i < 3000; ++i)
+    text += "  x = 'c' + \"str\" != 3.5\n\n";
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string(text);
+  TokenBuffer tokens = Lexer(source).tokenize_all();
+  string expected;
+  for (size_t i = 0; i < tokens.size(); ++i)
+    expected += to_string(tokens.token(i)) + "\n";
+  ostringstream out;
+  write_tokens(tokens, out);
+  ASSERT_EQ(expected, out.str());
+}
+
+TEST(BasicLexerTest, TokenTypeNames) {
+  ASSERT_EQ("EOS", token_type_name(TokenType::EOS));
+  ASSERT_EQ("LBRACE", token_type_name(TokenType::LBRACE));
+  ASSERT_EQ("GREATER_EQ", token_type_name(TokenType::GREATER_EQ));
+  ASSERT_EQ("STRING_TYPE", token_type_name(TokenType::STRING_TYPE));
+  ASSERT_EQ("RETURN", token_type_name(TokenType::RETURN));
+  ASSERT_EQ("1, 3: ID 'x'", to_string(Token(TokenType::ID, "x", 1, 3)));
+}
+
+TEST(BasicLexerTest, StreamingMatchesBuffered) {
+  string text = "struct S {\n  int x; # comment\n}\n" + string(40, 'w') +
+    " = \"" + string(30, 's') + "\" '\\n' 12345.678\n\n  'x' y";
+  for (size_t chunk : {1, 2, 3, 7, 16, 1000}) {
+    Lexer buffered(SourceBuffer::from_string(text));
+    stringstream in(text);
+    Lexer streaming(make_shared<StreamSource>(in, chunk));
+    Token expected, actual;
+    do {
+      expected = buffered.next_token();
+      actual = streaming.next_token();
+      ASSERT_EQ(expected.type(), actual.type());
+      ASSERT_EQ(expected.lexeme_view(), actual.lexeme_view());
+      ASSERT_EQ(expected.line(), actual.line());
+      ASSERT_EQ(expected.column(), actual.column());
+      ASSERT_EQ(expected.symbol(), actual.symbol());
+      ASSERT_EQ(expected.double_value(), actual.double_value());
+    } while (expected.type() != TokenType::EOS);
+  }
+}
+
+TEST(BasicLexerTest, StreamingReleasesWindows) {
+  string text;
+  for (int i = 0; i < 100; ++i)
+    text += "x = 1\n";
+  stringstream in(text);
+  Lexer lexer(make_shared<StreamSource>(in, 8));
+  weak_ptr<const SourceBuffer> first = lexer.source_buffer();
+  Token kept = lexer.next_token();
+  for (int i = 0; i < 10; ++i)
+    lexer.next_token();
+  // the first window lives on only through the token lexed from it
+  ASSERT_FALSE(first.expired());
+  ASSERT_EQ("x", kept.lexeme_view());
+  kept = Token();
+  ASSERT_TRUE(first.expired());
+  ASSERT_GT(100, lexer.source_buffer()->size());
+}
+
+TEST(BasicLexerTest, StreamingErrorPosition) {
+  stringstream in("x = 1\ny = 2\n  z = ?\n");
+  Lexer lexer(make_shared<StreamSource>(in, 4));
+  ostringstream out;
+  try {
+    write_tokens(lexer, out);
+    FAIL();
+  } catch(MyPLException& e) {
+    string m = e.what();
+    ASSERT_EQ("Lexer Error: unexpected character '?' at line 3, column 7", m);
+  }
+  ASSERT_EQ("1, 1: ID 'x'\n1, 3: ASSIGN '='\n1, 5: INT_VAL '1'\n"
+            "2, 1: ID 'y'\n2, 3: ASSIGN '='\n2, 5: INT_VAL '2'\n"
+            "3, 3: ID 'z'\n3, 5: ASSIGN '='\n", out.str());
+}
+
+TEST(BasicLexerTest, OversizedSourcesAreRejected) {
+  stringstream in("x = 1\n");
+  ASSERT_THROW(SourceBuffer::from_stream(in, 5), MyPLException);
+  filesystem::path file = filesystem::temp_directory_path() /
+    ("mypl_big_" + to_string(hash_bytes(__FILE__, sizeof(__FILE__))));
+  ofstream(file, ios::binary) << "x = 1\n";
+  ASSERT_THROW(SourceBuffer::from_file(file.string(), 5), MyPLException);
+  ASSERT_EQ(6, SourceBuffer::from_file(file.string(), 6)->size());
+  // token offsets are 32 bits (the file is sparse, so it is never read)
+  filesystem::resize_file(file, MAX_SOURCE_SIZE + 1);
+  ASSERT_THROW(SourceBuffer::from_file(file.string()), MyPLException);
+  filesystem::remove(file);
+}
+
+TEST(BasicLexerTest, TokenCacheRoundTrip) {
+  filesystem::path dir = filesystem::temp_directory_path() /
+    ("mypl_tok_" + to_string(hash_bytes(__FILE__, sizeof(__FILE__))));
+  filesystem::remove_all(dir);
+  filesystem::create_directory(dir);
+  TokenCache cache(dir.string());
+  for (string text : {"int x = 42 # c\n  y2 = x + 3.25 * 'a' \"s t\"\n",
+                      "x = y\nz = ?\n", ""}) {
+    shared_ptr<SourceBuffer> source = SourceBuffer::from_string(text);
+    TokenBuffer lexed = Lexer(source).tokenize_all();
+    ASSERT_FALSE(cache.load(source).has_value());
+    expect_same_tokens(lexed, cache.tokenize(source));
+    optional<TokenBuffer> cached = cache.load(source);
+    ASSERT_TRUE(cached.has_value());
+    expect_same_tokens(lexed, *cached);
+  }
+  // a changed source has its own file
+  ASSERT_FALSE(cache.load(SourceBuffer::from_string("int x = 43")).has_value());
+  filesystem::remove_all(dir);
+}
+
+TEST(BasicLexerTest, TokenCacheRejectsBadFiles) {
+  filesystem::path dir = filesystem::temp_directory_path() /
+    ("mypl_tok_bad_" + to_string(hash_bytes(__FILE__, sizeof(__FILE__))));
+  filesystem::remove_all(dir);
+  filesystem::create_directory(dir);
+  TokenCache cache(dir.string());
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string("a = b + c\n");
+  ASSERT_TRUE(cache.store(Lexer(source).tokenize_all()));
+  string file = cache.path(hash_bytes(source->begin(), source->size()));
+  string bytes(SourceBuffer::from_file(file)->text());
+  // written by a different lexer version
+  string stale = bytes;
+  stale[12] ^= 1;
+  ofstream(file, ios::binary) << stale;
+  ASSERT_FALSE(cache.load(source).has_value());
+  // cut short
+  ofstream(file, ios::binary) << bytes.substr(0, bytes.size() - 1);
+  ASSERT_FALSE(cache.load(source).has_value());
+  // for a different source of the same size and hash
+  shared_ptr<SourceBuffer> other = SourceBuffer::from_string("a = b + d\n");
+  ASSERT_TRUE(cache.store(Lexer(other).tokenize_all()));
+  string colliding(SourceBuffer::from_file(
+    cache.path(hash_bytes(other->begin(), other->size())))->text());
+  uint64_t source_hash = hash_bytes(source->begin(), source->size());
+  memcpy(colliding.data() + 16, &source_hash, sizeof(source_hash));
+  ofstream(file, ios::binary) << colliding;
+  ASSERT_FALSE(cache.load(source).has_value());
+  ofstream(file, ios::binary) << bytes;
+  ASSERT_TRUE(cache.load(source).has_value());
+  filesystem::remove_all(dir);
+}
+
+TEST(BasicLexerTest, ReplayedTokens) {
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string("x = 1\ny ?\n");
+  Lexer lexer(make_shared<TokenBuffer>(Lexer(source).tokenize_all()));
+  ASSERT_EQ("1, 1: ID 'x'", to_string(lexer.next_token()));
+  ASSERT_EQ("1, 3: ASSIGN '='", to_string(lexer.next_token()));
+  ASSERT_EQ("1, 5: INT_VAL '1'", to_string(lexer.next_token()));
+  ASSERT_EQ("2, 1: ID 'y'", to_string(lexer.next_token()));
+  try {
+    lexer.next_token();
+    FAIL();
+  } catch(MyPLException& e) {
+    string m = e.what();
+    ASSERT_EQ("Lexer Error: unexpected character '?' at line 2, column 3", m);
+  }
+}
+
+TEST(BasicLexerTest, RelexMatchesFullLex) {
+  // every small edit at every position of sources with and without errors
+  vector<string> sources = {
+    "int x = 42 # note\n  s = \"a b\" + 'c'\n\nif (x >= 3.5) { f(x) }\n",
+    "x = 1\ny = ? + 2\n  z = \"s\"\n", "'\\n\nx"};
+  vector<string> texts = {"", "x", "\n", "\"", "'", "#", "1.", "?", " 7 "};
+  for (const string& text : sources) {
+    shared_ptr<SourceBuffer> source = SourceBuffer::from_string(text);
+    TokenBuffer old_tokens = Lexer(source).tokenize_all();
+    for (size_t begin = 0; begin <= text.size(); ++begin) {
+      for (size_t end : {begin, begin + 1, begin + 4}) {
+        if (end > text.size())
+          continue;
+        for (const string& insert : texts) {
+          SourceEdit edit {begin, end, insert};
+          TokenBuffer relexed = relex(old_tokens, edit);
+          TokenBuffer lexed = Lexer(apply_edit(*source, edit)).tokenize_all();
+          expect_same_tokens(lexed, relexed);
+          ASSERT_EQ(lexed.source_buffer()->text(),
+                    relexed.source_buffer()->text());
+        }
+      }
+    }
+  }
+}
+
+TEST(BasicLexerTest, RelexShiftsLaterTokens) {
+  shared_ptr<SourceBuffer> source =
+    SourceBuffer::from_string("x = 1\ny = 2\nz = 3\n");
+  TokenBuffer tokens = relex(Lexer(source).tokenize_all(),
+                             SourceEdit {4, 5, "(1 +\n 10)"});
+  ASSERT_EQ("x = (1 +\n 10)\ny = 2\nz = 3\n",
+            tokens.source_buffer()->text());
+  ASSERT_EQ(14, tokens.size());
+  ASSERT_EQ("10", tokens.lexeme(5));
+  ASSERT_EQ(2, tokens.line(5));
+  ASSERT_EQ("z", tokens.lexeme(10));
+  ASSERT_EQ(4, tokens.line(10));
+  ASSERT_EQ(1, tokens.column(10));
+  ASSERT_EQ(TokenType::EOS, tokens.type(13));
+}
+
+TEST(BasicLexerTest, RelexOutOfBounds) {
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string("x = 1");
+  TokenBuffer tokens = Lexer(source).tokenize_all();
+  try {
+    relex(tokens, SourceEdit {3, 9, ""});
+    FAIL();
+  } catch(MyPLException& e) {
+    string m = e.what();
+    ASSERT_EQ("Lexer Error: edit range out of bounds", m);
+  }
+}
+
 //------------------------------------------------------------
 // Negative Test Cases
 //------------------------------------------------------------
@@ -648,6 +1110,34 @@ TEST(BasicLexerTest, InvalidSymbol) {
   }
 }
 
+TEST(BasicLexerTest, IntOutOfRange) {
+  stringstream in("x = 9223372036854775808");
+  Lexer lexer(in);
+  lexer.next_token();
+  lexer.next_token();
+  try {
+    lexer.next_token();
+    FAIL();
+  } catch(MyPLException& e) {
+    string m = e.what();
+    ASSERT_EQ("Lexer Error: int value out of range '9223372036854775808' "
+              "at line 1, column 5", m);
+  }
+}
+
+TEST(BasicLexerTest, DoubleOutOfRange) {
+  stringstream in("1" + string(400, '0') + ".0");
+  Lexer lexer(in);
+  try {
+    lexer.next_token();
+    FAIL();
+  } catch(MyPLException& e) {
+    string m = e.what();
+    ASSERT_EQ(0, m.find("Lexer Error: double value out of range '1000"));
+    ASSERT_NE(string::npos, m.find("' at line 1, column 1"));
+  }
+}
+
 
 //----------------------------------------------------------------------
 // main
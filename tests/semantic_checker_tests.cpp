@@ -6,11 +6,19 @@
 //----------------------------------------------------------------------
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <string>
 #include <vector>
 #include "mypl_exception.h"
 #include "lexer.h"
+#include "simple_parser.h"
 #include "ast_parser.h"
+#include "parallel_parser.h"
+#include "ast_file.h"
+#include "print_visitor.h"
 #include "semantic_checker.h"
 
 using namespace std;
@@ -637,6 +645,52 @@ TEST(BasicSemanticCheckerTests, TooManyArgsInFunctionCall) {
   }
 }
 
+TEST(BasicSemanticCheckerTests, OperatorPrecedence) {
+  stringstream in(build_string({
+        "void main() {",
+        "  int x = 1",
+        "  bool x1 = x < 3 and 2.5 >= 1.0 or x + 1 * 2 == 3",
+        "  bool x2 = 1 + 2 * 3 < 4 - 5 / 6",
+        "  bool x3 = true and not x > 1 and x < 2",
+        "}",
+      }));
+  SemanticChecker checker;
+  ASTParser(Lexer(in)).parse().accept(checker);
+}
+
+TEST(BasicSemanticCheckerTests, BadPrecedenceGrouping) {
+  stringstream in(build_string({
+        "void main() {",
+        "  int x1 = 1 < 2 + 3",
+        "}",
+      }));
+  SemanticChecker checker;
+  try {
+    ASTParser(Lexer(in)).parse().accept(checker);
+    FAIL();
+  } catch (MyPLException& ex) {
+    string msg = ex.what();
+    ASSERT_TRUE(msg.starts_with("Static Error:"));
+  }
+}
+
+TEST(BasicSemanticCheckerTests, LongOperatorChains) {
+  string chain = "1";
+  for (int i = 0; i < 100000; ++i)
+    chain += (i % 2) ? " + 2" : " * 3";
+  stringstream in(build_string({
+        "void main() {",
+        "  int x1 = " + chain,
+        "  bool x2 = " + chain + " < " + chain,
+        "}",
+      }));
+  SemanticChecker checker;
+  Program p = ASTParser(Lexer(in)).parse();
+  p.accept(checker);
+  VarDeclStmt* x1 = static_cast<VarDeclStmt*>(p.fun_defs[0].stmts[0]);
+  ASSERT_EQ(100000, x1->expr.nodes.size());
+}
+
 //----------------------------------------------------------------------
 // Shadowing
 //----------------------------------------------------------------------
@@ -1429,6 +1483,694 @@ TEST(BasicSemanticCheckerTests, ArrayCallInvalidTypeInIf) {
     ASSERT_TRUE(msg.starts_with("Static Error:"));
   }
 }
+
+//----------------------------------------------------------------------
+// AST Construction Tests
+//----------------------------------------------------------------------
+
+// nodes can only be moved (so parsing never copies a subtree)
+static_assert(!is_copy_constructible_v<IfStmt>);
+static_assert(!is_copy_constructible_v<Expr>);
+static_assert(!is_copy_constructible_v<FunDef>);
+static_assert(is_nothrow_move_constructible_v<FunDef>);
+
+// number of allocations made (through the replaced global operator new)
+atomic<size_t> allocations = 0;
+
+void* operator new(size_t size)
+{
+  ++allocations;
+  if (void* p = malloc(size ? size : 1))
+    return p;
+  throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+  free(p);
+}
+
+// what parsing a program with depth nested while and if stmts takes
+struct NestedProgramCost
+{
+  size_t bytes;        // arena bytes used
+  size_t nodes;        // nodes constructed (each numbered once)
+  size_t allocations;  // heap allocations made while parsing
+};
+
+NestedProgramCost nested_program_cost(int depth)
+{
+  string text = "void main() {\n";
+  for (int i = 0; i < depth; ++i)
+    text += "while (x < (1 + y[i].z)) { if (true) { f(x, 2) }\n";
+  for (int i = 0; i < depth; ++i)
+    text += "}\n";
+  // lex first, so only the parse is counted
+  ASTParser parser(make_shared<TokenBuffer>(
+    Lexer(SourceBuffer::from_string(text + "}\n")).tokenize_all()));
+  size_t before = allocations;
+  Program p = parser.parse();
+  return {p.arena->bytes_used(), p.node_count, allocations - before};
+}
+
+// each level of nesting costs the same whatever its depth: the same
+// arena bytes and nodes exactly, and the same heap allocations give or
+// take the few made as the arena's block and destructor lists double.
+// Copying (or rebuilding) the subtree below each level would instead
+// cost in proportion to the depth, i.e., quadratic growth overall.
+TEST(BasicSemanticCheckerTests, ArenaGrowthIsLinearInNestingDepth) {
+  NestedProgramCost small = nested_program_cost(100);
+  NestedProgramCost medium = nested_program_cost(200);
+  NestedProgramCost large = nested_program_cost(400);
+  ASSERT_LT(0, small.bytes);
+  ASSERT_EQ(large.bytes - medium.bytes, 2 * (medium.bytes - small.bytes));
+  ASSERT_EQ(large.nodes - medium.nodes, 2 * (medium.nodes - small.nodes));
+  ASSERT_LT(0, small.allocations);
+  ASSERT_LE(large.allocations - medium.allocations,
+            2 * (medium.allocations - small.allocations) + 4);
+}
+
+// error message from parsing and checking text, given the lexed tokens
+// (if buffered) or lexing as it parses
+string parse_error(const string& text, bool buffered)
+{
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string(text);
+  try {
+    SemanticChecker checker;
+    if (buffered)
+      ASTParser(make_shared<TokenBuffer>(Lexer(source).tokenize_all()))
+        .parse().accept(checker);
+    else
+      ASTParser(Lexer(source)).parse().accept(checker);
+  } catch (MyPLException& ex) {
+    return ex.what();
+  }
+  return "";
+}
+
+TEST(BasicSemanticCheckerTests, ParseFromTokenBuffer) {
+  vector<string> texts = {
+    build_string({
+        "struct T {int x}",
+        "void f(T t) {}",
+        "void main() {",
+        "  T t = new T",
+        "  t.x = 1 + 2 * 3",
+        "  f(t)",
+        "  T u = t",
+        "  int y = t.x",
+        "}"}),
+    "void main() { int x = 1 int y = x + }",  // parser error
+    "void main() { int x = 1 }\nvoid f(",     // parser error at EOS
+    "void main() { int x = 1 + $ }",          // lexer error
+    "void main() { int x = true }",           // semantic error
+  };
+  ASSERT_EQ("", parse_error(texts[0], true));
+  for (const string& text : texts)
+    ASSERT_EQ(parse_error(text, false), parse_error(text, true));
+  ASSERT_TRUE(parse_error(texts[3], true).starts_with("Lexer Error"));
+}
+
+TEST(BasicSemanticCheckerTests, TokenCursorLookahead) {
+  shared_ptr<SourceBuffer> source = SourceBuffer::from_string("x = f(1)");
+  TokenCursor buffered(make_shared<TokenBuffer>(Lexer(source).tokenize_all()));
+  TokenCursor streamed {Lexer(source)};
+  for (TokenCursor* c : {&buffered, &streamed}) {
+    c->advance();
+    ASSERT_EQ(TokenType::ID, c->type());
+    ASSERT_EQ(TokenType::LPAREN, c->peek(3));
+    ASSERT_EQ(TokenType::EOS, c->peek(6));
+    ASSERT_EQ(TokenType::EOS, c->peek(100));
+    c->advance();
+    ASSERT_EQ(TokenType::ASSIGN, c->type());
+    ASSERT_EQ("=", c->token().lexeme());
+    ASSERT_EQ(TokenType::ID, c->peek(1));
+    for (int i = 0; i < 6; ++i)
+      c->advance();
+    ASSERT_EQ(TokenType::EOS, c->type());
+  }
+}
+
+shared_ptr<TokenBuffer> lex_all(const string& text)
+{
+  return make_shared<TokenBuffer>(
+    Lexer(SourceBuffer::from_string(text)).tokenize_all());
+}
+
+// error message from parsing the text in parallel or serially
+string parallel_parse_error(const string& text, bool parallel)
+{
+  try {
+    if (parallel)
+      parse_parallel(lex_all(text), 4, 1);
+    else
+      ASTParser(lex_all(text)).parse();
+  } catch (MyPLException& ex) {
+    return ex.what();
+  }
+  return "";
+}
+
+// a program of n structs and n + 2 functions
+string many_definitions(int n)
+{
+  string text;
+  for (int i = 0; i < n; ++i) {
+    string s = "S" + to_string(i);
+    text += "struct " + s + " {int x, array double y}\n";
+    text += "array int f" + to_string(i) + "(" + s + " s, int n) {\n";
+    text += "  " + s + " t = new " + s + "\n";
+    text += "  t.x = s.x + n * 2\n";
+    text += "  if (n > 0) { while (true) { g(n) } }\n";
+    text += "  return new int[n]\n";
+    text += "}\n";
+  }
+  return text + "void g(int n) {}\nvoid main() {}\n";
+}
+
+TEST(BasicSemanticCheckerTests, DefinitionStarts) {
+  string text = build_string({
+      "struct S {int x}",
+      "array int f(int x) { g(1) }",
+      "S h() {}",
+      "void main() {}"});
+  vector<size_t> starts = definition_starts(*lex_all(text));
+  ASSERT_EQ(vector<size_t>({0, 6, 19, 25}), starts);
+}
+
+TEST(BasicSemanticCheckerTests, ParallelParseMatchesSerial) {
+  shared_ptr<TokenBuffer> tokens = lex_all(many_definitions(50));
+  Program serial = ASTParser(tokens).parse();
+  Program parallel = parse_parallel(tokens, 4, 1);
+  ASSERT_EQ(50, parallel.struct_defs.size());
+  ASSERT_EQ(52, parallel.fun_defs.size());
+  for (size_t i = 0; i < serial.struct_defs.size(); ++i)
+    ASSERT_EQ(serial.struct_defs[i].struct_name.offset(),
+              parallel.struct_defs[i].struct_name.offset());
+  for (size_t i = 0; i < serial.fun_defs.size(); ++i) {
+    FunDef& f = parallel.fun_defs[i];
+    ASSERT_EQ(serial.fun_defs[i].fun_name.offset(), f.fun_name.offset());
+    ASSERT_EQ(serial.fun_defs[i].stmts.size(), f.stmts.size());
+    ASSERT_EQ(serial.fun_defs[i].return_type.is_array,
+              f.return_type.is_array);
+  }
+  ASSERT_EQ(parallel.source, tokens->source_buffer());
+  SemanticChecker checker;
+  parallel.accept(checker);
+}
+
+TEST(BasicSemanticCheckerTests, ParallelParseErrorsMatchSerial) {
+  string text = many_definitions(20);
+  size_t middle = text.find("t.x = s.x", text.size() / 2);
+  vector<string> texts = {
+    text.substr(0, middle) + "t.x = = 1" + text.substr(middle + 9),
+    text.substr(0, middle) + "t.x = $ 1" + text.substr(middle + 9),
+    text.substr(0, middle) + "}" + text.substr(middle),
+    text + "void f(",
+  };
+  for (const string& t : texts) {
+    string msg = parallel_parse_error(t, false);
+    ASSERT_NE("", msg);
+    ASSERT_EQ(msg, parallel_parse_error(t, true));
+  }
+}
+
+// the pretty printed program
+string printed(Program& p)
+{
+  stringstream out;
+  PrintVisitor printer(out);
+  p.accept(printer);
+  return out.str();
+}
+
+// the bytes of the program's .ast file
+string ast_bytes(Program& p)
+{
+  stringstream out;
+  EXPECT_TRUE(write_ast(p, out));
+  return out.str();
+}
+
+TEST(BasicSemanticCheckerTests, AstFileRoundTrip) {
+  string text = build_string({
+      "struct T {int x, array double y, T next}",
+      "array T f(T t, array int xs) {",
+      "  T u = new T",
+      "  u.next.x = xs[0] + 3 * 40000000000 / 2 - 1",
+      "  u.y = new double[3]",
+      "  u.y[1] = 2.5",
+      "  for (int i = 0; i < 10; i = i + 1) { delete u }",
+      "  if (not u.x > 1 or u.x == 2) { return null }",
+      "  elseif ((1 + 2) * 3 >= 4 and true) { f(t, xs) }",
+      "  else { while (false) { string s = \"hi\" char c = 'c' } }",
+      "  return new T[xs[u.x] + g(xs)]",
+      "}",
+      "void main() {}"});
+  Program p = ASTParser(lex_all(text)).parse();
+  string bytes = ast_bytes(p);
+  optional<Program> q = load_ast(SourceBuffer::from_string(bytes));
+  ASSERT_TRUE(q.has_value());
+  ASSERT_EQ(printed(p), printed(*q));
+  ASSERT_EQ(text, q->source->text());
+  // tokens keep their values, positions, and symbols
+  VarDeclStmt& u = *static_cast<VarDeclStmt*>(q->fun_defs[0].stmts[0]);
+  ASSERT_EQ(3, u.var_def.var_name.position(*q->source).line);
+  ASSERT_EQ(5, u.var_def.var_name.position(*q->source).column);
+  ASSERT_EQ(p.fun_defs[0].fun_name.symbol(), q->fun_defs[0].fun_name.symbol());
+  // literals keep their values (from lexing, or converted on loading)
+  for (Program* r : {&p, &*q}) {
+    AssignStmt& a = *static_cast<AssignStmt*>(r->fun_defs[0].stmts[1]);
+    SimpleTerm& n = *static_cast<SimpleTerm*>(a.expr.rest[1].term);
+    ASSERT_EQ(40000000000,
+              static_cast<SimpleRValue*>(n.rvalue)->literal.int_value);
+    AssignStmt& d = *static_cast<AssignStmt*>(r->fun_defs[0].stmts[3]);
+    SimpleTerm& x = *static_cast<SimpleTerm*>(d.expr.first);
+    ASSERT_EQ(2.5, static_cast<SimpleRValue*>(x.rvalue)->literal.double_value);
+  }
+  // writing the loaded program gives the same file
+  ASSERT_EQ(bytes, ast_bytes(*q));
+}
+
+TEST(BasicSemanticCheckerTests, AstFileCheckErrors) {
+  string text = build_string({
+      "void main() {",
+      "  int x = 1",
+      "  bool y = x + 2",
+      "}"});
+  Program p = ASTParser(lex_all(text)).parse();
+  optional<Program> q = load_ast(SourceBuffer::from_string(ast_bytes(p)));
+  ASSERT_TRUE(q.has_value());
+  string expected = parse_error(text, true);
+  try {
+    SemanticChecker checker;
+    q->accept(checker);
+    FAIL();
+  } catch (MyPLException& ex) {
+    ASSERT_EQ(expected, ex.what());
+  }
+}
+
+TEST(BasicSemanticCheckerTests, AstFileRejectsBadFiles) {
+  Program p = ASTParser(lex_all(many_definitions(3))).parse();
+  string bytes = ast_bytes(p);
+  ASSERT_TRUE(load_ast(SourceBuffer::from_string(bytes)).has_value());
+  // truncated, extended, or wrong format
+  for (size_t size : {size_t(0), size_t(20), bytes.size() / 2,
+                      bytes.size() - 1})
+    ASSERT_FALSE(load_ast(SourceBuffer::from_string(bytes.substr(0, size))));
+  ASSERT_FALSE(load_ast(SourceBuffer::from_string(bytes + "x")));
+  string bad = bytes;
+  bad[8] ^= 1;
+  ASSERT_FALSE(load_ast(SourceBuffer::from_string(bad)));
+  // any corrupted node byte is either rejected or still loads safely
+  for (size_t i = bytes.size() - 200; i < bytes.size(); ++i) {
+    bad = bytes;
+    bad[i] ^= 0x5a;
+    optional<Program> q = load_ast(SourceBuffer::from_string(bad));
+    if (q)
+      printed(*q);
+  }
+  ASSERT_FALSE(load_ast("no/such/file.ast"));
+}
+
+TEST(BasicSemanticCheckerTests, AstFileRejectsDeepNesting) {
+  // nodes opening far more parenthesized terms than the file closes
+  // (read without recursion, so rejected rather than overflowing the
+  // stack)
+  Program p = ASTParser(lex_all("void main() { int x = ((((1)))) }")).parse();
+  string bytes = ast_bytes(p);
+  string groups(4, static_cast<char>(NodeKind::COMPLEX_TERM));
+  size_t run = bytes.rfind(groups);
+  ASSERT_NE(string::npos, run);
+  size_t extra = 200000;
+  bytes.insert(run, string(extra, groups[0]));
+  // (the header's nodes size is its last field)
+  uint64_t nodes_size;
+  memcpy(&nodes_size, bytes.data() + 40, sizeof(nodes_size));
+  nodes_size += extra;
+  memcpy(bytes.data() + 40, &nodes_size, sizeof(nodes_size));
+  ASSERT_FALSE(load_ast(SourceBuffer::from_string(bytes)));
+}
+
+// error message from checking the syntax of the text (if syntax_only)
+// or parsing it into its AST
+string grammar_error(const string& text, bool syntax_only)
+{
+  try {
+    if (syntax_only)
+      SimpleParser(lex_all(text)).parse();
+    else
+      ASTParser(lex_all(text)).parse();
+  } catch (MyPLException& ex) {
+    return ex.what();
+  }
+  return "";
+}
+
+TEST(BasicSemanticCheckerTests, SyntaxCheckErrorsMatchParser) {
+  vector<string> texts = {
+    "void main() { int x = }",
+    "void main() { x.y[1 + ] = 2 }",
+    "void main() { if (true) {} elseif {} }",
+    "void main() { for (int i = 0; i < 3; j) {} }",
+    "void main() { new int }",
+    "void main() { f(1, 2 }",
+    "struct S { int x, }",
+    "array void f() {}",
+    "void main() { int x = not not (1 + 2) * }",
+    "void main() { delete x",
+  };
+  for (const string& t : texts) {
+    string msg = grammar_error(t, true);
+    ASSERT_NE("", msg);
+    ASSERT_EQ(msg, grammar_error(t, false));
+  }
+  ASSERT_EQ("", grammar_error(many_definitions(5), true));
+}
+
+TEST(BasicSemanticCheckerTests, TruncatedProgramErrorsMatchParser) {
+  // each ends where the parser expects a token it would store
+  vector<string> texts = {
+    "void main() {}\nint",
+    "struct",
+    "void main() { x = new",
+    "void main() { int x = ",
+    "void main() { x = f(1, ",
+    "void main() { x = y.",
+    "void main() { x = 1 +",
+  };
+  for (const string& t : texts) {
+    string msg = grammar_error(t, true);
+    ASSERT_EQ(0, msg.find("Parser Error:"));
+    ASSERT_EQ(msg, grammar_error(t, false));
+  }
+}
+
+TEST(BasicSemanticCheckerTests, SyntaxCheckDoesNotAllocate) {
+  shared_ptr<TokenBuffer> tokens = lex_all(many_definitions(50));
+  SimpleParser parser(tokens);
+  size_t before = allocations;
+  parser.parse();
+  ASSERT_EQ(before, allocations);
+  // while building the AST does
+  ASTParser ast_parser(tokens);
+  before = allocations;
+  ast_parser.parse();
+  ASSERT_LT(before, allocations);
+}
+
+// an int expression of depth nested parentheses, each around n terms
+string nested_parens(int depth, int n)
+{
+  string terms = "1";
+  for (int i = 1; i < n; ++i)
+    terms += (i % 2) ? " + 1" : " * 1";
+  string text;
+  for (int i = 0; i < depth; ++i)
+    text += "(" + terms + " + ";
+  text += "1";
+  for (int i = 0; i < depth; ++i)
+    text += ")";
+  return text;
+}
+
+TEST(BasicSemanticCheckerTests, DeeplyNestedExpressions) {
+  // far deeper than the thread stack allows with recursion
+  for (string e : {nested_parens(100000, 1), nested_parens(10, 10000)}) {
+    string text = "void main() { int x = " + e + " }";
+    ASSERT_EQ("", grammar_error(text, true));
+    SemanticChecker checker;
+    Program p = ASTParser(lex_all(text)).parse();
+    p.accept(checker);
+    // and round trips through an .ast file
+    string bytes = ast_bytes(p);
+    optional<Program> q = load_ast(SourceBuffer::from_string(bytes));
+    ASSERT_TRUE(q.has_value());
+    ASSERT_EQ(p.node_count, q->node_count);
+    ASSERT_EQ(bytes, ast_bytes(*q));
+    SemanticChecker q_checker;
+    q->accept(q_checker);
+  }
+  // errors deep inside still found
+  string e = nested_parens(100000, 1);
+  string bad = "void main() { int x = " + e.substr(0, e.size() - 1) + " }";
+  string msg = grammar_error(bad, true);
+  ASSERT_EQ(0, msg.find("Parser Error: Expecting RPAREN"));
+  ASSERT_EQ(msg, grammar_error(bad, false));
+  size_t one = e.find("1");
+  string mistyped = e.substr(0, one) + "true" + e.substr(one + 1);
+  Program p = ASTParser(lex_all("void main() { int x = " + mistyped + " }"))
+    .parse();
+  try {
+    SemanticChecker checker;
+    p.accept(checker);
+    FAIL();
+  } catch (MyPLException& ex) {
+    msg = ex.what();
+    ASSERT_EQ(0, msg.find("Static Error:"));
+  }
+}
+
+TEST(BasicSemanticCheckerTests, NodeKindsMatchNodeTypes) {
+  string text = build_string({
+      "struct S {int x}",
+      "int f(S s) {",
+      "  int x = s.x + (1 * 2)",
+      "  x = f(new S)",
+      "  while (x > 0) { x = x - 1 }",
+      "  for (int i = 0; i < 3; i = i + 1) {}",
+      "  if (x == 0) {} else {}",
+      "  delete s",
+      "  f(null)",
+      "  return x",
+      "}",
+      "void main() {}"});
+  Program p = ASTParser(lex_all(text)).parse();
+  vector<Stmt*>& stmts = p.fun_defs[0].stmts;
+  vector<NodeKind> kinds = {NodeKind::VAR_DECL_STMT, NodeKind::ASSIGN_STMT,
+    NodeKind::WHILE_STMT, NodeKind::FOR_STMT, NodeKind::IF_STMT,
+    NodeKind::DELETE_STMT, NodeKind::CALL_EXPR, NodeKind::RETURN_STMT};
+  ASSERT_EQ(kinds.size(), stmts.size());
+  for (size_t i = 0; i < stmts.size(); ++i) {
+    ASSERT_EQ(kinds[i], stmts[i]->kind);
+    // dispatch reaches the node's own type
+    Stmt* s = dispatch(*stmts[i], [](auto& n) -> Stmt* {return &n;});
+    ASSERT_EQ(stmts[i], s);
+  }
+  Expr& e = static_cast<VarDeclStmt*>(stmts[0])->expr;
+  ASSERT_EQ(NodeKind::SIMPLE_TERM, e.first->kind);
+  ASSERT_EQ(NodeKind::COMPLEX_TERM, e.rest[0].term->kind);
+  RValue* v = static_cast<SimpleTerm*>(e.first)->rvalue;
+  ASSERT_EQ(NodeKind::VAR_RVALUE, v->kind);
+  Expr& call = static_cast<AssignStmt*>(stmts[1])->expr;
+  RValue* c = static_cast<SimpleTerm*>(call.first)->rvalue;
+  ASSERT_EQ(NodeKind::CALL_EXPR, c->kind);
+  ASSERT_TRUE(dispatch(*c, [](auto& n) {
+    return is_same_v<decay_t<decltype(n)>, CallExpr>;
+  }));
+  SemanticChecker checker;
+  p.accept(checker);
+}
+
+// the ids of a program's nodes in source order (a call's id from each
+// of its bases)
+class IdCollector : public Visitor
+{
+public:
+  vector<NodeId> ids;
+  void visit(Program& p)
+  {
+    ids.push_back(p.id);
+    for (StructDef& s : p.struct_defs)
+      s.accept(*this);
+    for (FunDef& f : p.fun_defs)
+      f.accept(*this);
+  }
+  void visit(FunDef& f) {ids.push_back(f.id); stmts(f.stmts);}
+  void visit(StructDef& s) {ids.push_back(s.id);}
+  void visit(ReturnStmt& s) {ids.push_back(s.id); s.expr.accept(*this);}
+  void visit(WhileStmt& s)
+  {
+    ids.push_back(s.id);
+    s.condition.accept(*this);
+    stmts(s.stmts);
+  }
+  void visit(ForStmt& s)
+  {
+    ids.push_back(s.id);
+    s.var_decl.accept(*this);
+    s.condition.accept(*this);
+    s.assign_stmt.accept(*this);
+    stmts(s.stmts);
+  }
+  void visit(IfStmt& s)
+  {
+    ids.push_back(s.id);
+    for (BasicIf* b = &s.if_part; b; b = nullptr) {
+      b->condition.accept(*this);
+      stmts(b->stmts);
+    }
+    for (BasicIf& b : s.else_ifs) {
+      b.condition.accept(*this);
+      stmts(b.stmts);
+    }
+    stmts(s.else_stmts);
+  }
+  void visit(VarDeclStmt& s) {ids.push_back(s.id); s.expr.accept(*this);}
+  void visit(AssignStmt& s)
+  {
+    ids.push_back(s.id);
+    path(s.lvalue);
+    s.expr.accept(*this);
+  }
+  void visit(DeleteStmt& s) {ids.push_back(s.id); s.expr.accept(*this);}
+  void visit(CallExpr& e)
+  {
+    EXPECT_EQ(e.Stmt::id, e.RValue::id);
+    ids.push_back(e.Stmt::id);
+    for (Expr& a : e.args)
+      a.accept(*this);
+  }
+  void visit(Expr& e)
+  {
+    ids.push_back(e.id);
+    for (size_t i = 0; i <= e.rest.size(); ++i)
+      e.term(i)->accept(*this);
+  }
+  void visit(SimpleTerm& t) {ids.push_back(t.id); t.rvalue->accept(*this);}
+  void visit(ComplexTerm& t) {ids.push_back(t.id); t.expr.accept(*this);}
+  void visit(SimpleRValue& v) {ids.push_back(v.id);}
+  void visit(NewRValue& v)
+  {
+    ids.push_back(v.id);
+    if (v.array_expr)
+      v.array_expr->accept(*this);
+  }
+  void visit(VarRValue& v) {ids.push_back(v.id); path(v.path);}
+private:
+  void stmts(vector<Stmt*>& s)
+  {
+    for (Stmt* t : s)
+      t->accept(*this);
+  }
+  void path(vector<VarRef>& p)
+  {
+    for (VarRef& r : p)
+      if (r.array_expr)
+        r.array_expr->accept(*this);
+  }
+};
+
+vector<NodeId> node_ids(Program& p)
+{
+  IdCollector collector;
+  p.accept(collector);
+  return collector.ids;
+}
+
+TEST(BasicSemanticCheckerTests, NodeIdsAreDenseInSourceOrder) {
+  string text = build_string({
+      "struct T {int x, array double y, T next}",
+      "array T f(T t, array int xs) {",
+      "  T u = new T",
+      "  u.next.x = xs[0] + 3 * 4 / 2 - 1",
+      "  for (int i = 0; i < 10; i = i + 1) { delete u }",
+      "  if (not u.x > 1 or u.x == 2) { return null }",
+      "  elseif ((1 + 2) * 3 >= 4 and true) { f(t, xs) }",
+      "  else { while (false) { string s = \"hi\" } }",
+      "  return new T[xs[u.x] + g(xs)]",
+      "}",
+      "void main() {}"});
+  Program p = ASTParser(lex_all(text)).parse();
+  vector<NodeId> ids = node_ids(p);
+  ASSERT_EQ(p.node_count, ids.size());
+  for (size_t i = 0; i < ids.size(); ++i)
+    ASSERT_EQ(i, ids[i]);
+  // loading a program's .ast file gives the same ids
+  optional<Program> q = load_ast(SourceBuffer::from_string(ast_bytes(p)));
+  ASSERT_TRUE(q.has_value());
+  ASSERT_EQ(p.node_count, q->node_count);
+  ASSERT_EQ(ids, node_ids(*q));
+  // as does parsing in parallel
+  shared_ptr<TokenBuffer> tokens = lex_all(many_definitions(50));
+  Program serial = ASTParser(tokens).parse();
+  Program parallel = parse_parallel(tokens, 4, 1);
+  ASSERT_EQ(serial.node_count, parallel.node_count);
+  ASSERT_EQ(node_ids(serial), node_ids(parallel));
+}
+
+TEST(BasicSemanticCheckerTests, NodeTableHoldsPerNodeData) {
+  Program p = ASTParser(lex_all("void main() { int x = 1 + 2 }")).parse();
+  NodeTable<int> table(p, -1);
+  ASSERT_EQ(p.node_count, table.size());
+  Stmt& s = *p.fun_defs[0].stmts[0];
+  table[s] = 7;
+  ASSERT_EQ(7, table[s.id]);
+  ASSERT_EQ(-1, table[p.fun_defs[0]]);
+}
+
+TEST(BasicSemanticCheckerTests, CheckerRecordsTypes) {
+  string text = build_string({
+      "struct S {double x, array int y}",
+      "string f(S s) {",
+      "  bool b = (1 + 2) < 3",
+      "  f(s)",
+      "  array int a = s.y",
+      "  return to_string(s.x * 2.0)",
+      "}",
+      "void main() {}"});
+  Program p = ASTParser(lex_all(text)).parse();
+  SemanticChecker checker;
+  p.accept(checker);
+  auto type = [&](const ASTNode& n) {
+    const DataType& t = checker.type_of(n);
+    return (t.is_array ? "array " : "") + t.type_name;
+  };
+  vector<Stmt*>& stmts = p.fun_defs[0].stmts;
+  Expr& b = static_cast<VarDeclStmt*>(stmts[0])->expr;
+  ASSERT_EQ("bool", type(b));
+  ASSERT_EQ("int", type(*b.first));
+  ASSERT_EQ("int", type(static_cast<ComplexTerm*>(b.first)->expr));
+  ASSERT_EQ("int", type(*b.rest[0].term));
+  CallExpr& call = *static_cast<CallExpr*>(stmts[1]);
+  ASSERT_EQ("string", type(static_cast<Stmt&>(call)));
+  ASSERT_EQ("array int", type(static_cast<VarDeclStmt*>(stmts[2])->expr));
+  Expr& r = static_cast<ReturnStmt*>(stmts[3])->expr;
+  ASSERT_EQ("string", type(r));
+  CallExpr& to_string = *static_cast<CallExpr*>(
+    static_cast<SimpleTerm*>(r.first)->rvalue);
+  Expr& product = to_string.args[0];
+  ASSERT_EQ("double", type(product));
+  ASSERT_EQ("double", type(*static_cast<SimpleTerm*>(product.first)->rvalue));
+  // statements and definitions have no type
+  ASSERT_EQ("", type(*stmts[0]));
+  ASSERT_EQ("", type(p.fun_defs[1]));
+}
+
+TEST(BasicSemanticCheckerTests, CheckerCanBeReused) {
+  // the second program redefines the first one's struct and function
+  // names, and the first error leaves environments behind
+  string text = build_string({
+      "struct S {int x}",
+      "int f() {return 1}",
+      "void main() {S s = new S int y = f()}"});
+  Program bad = ASTParser(lex_all("void main() {while (true) {int x = 1.0}}")).parse();
+  Program p = ASTParser(lex_all(text)).parse();
+  Program q = ASTParser(lex_all(text)).parse();
+  SemanticChecker checker;
+  EXPECT_THROW(bad.accept(checker), MyPLException);
+  p.accept(checker);
+  q.accept(checker);
+  Expr& e = static_cast<VarDeclStmt*>(q.fun_defs[1].stmts[1])->expr;
+  ASSERT_EQ("int", checker.type_of(e).type_name);
+}
+
 //----------------------------------------------------------------------
 // main
 //----------------------------------------------------------------------